@@ -0,0 +1,46 @@
+#include "Arena.h"
+#include <algorithm>
+
+static const size_t ARENA_MIN_BLOCK = 4 << 10;  // first block 4 KB
+static const size_t ARENA_MAX_BLOCK = 1 << 20;  // blocks grow with use up to 1 MB
+
+Arena::Arena()
+{
+	m_Cur = nullptr;
+	m_Left = 0;
+	m_Reserved = 0;
+}
+
+Arena::~Arena()
+{
+	release();
+}
+
+void* Arena::alloc(size_t bytes)
+{
+	bytes = (bytes + 7) & ~(size_t)7;
+	if(bytes > m_Left) {
+		// small graphs stay small; oversized requests get a block of their own
+		size_t sz = std::min(std::max(m_Reserved, ARENA_MIN_BLOCK), ARENA_MAX_BLOCK);
+		if(bytes > sz) sz = bytes;
+		m_Cur = new char[sz];
+		m_Left = sz;
+		m_Blocks.push_back(m_Cur);
+		m_Reserved += sz;
+	}
+	void* p = m_Cur;
+	m_Cur += bytes;
+	m_Left -= bytes;
+	return p;
+}
+
+void Arena::release()
+{
+	for(size_t i = 0; i < m_Blocks.size(); ++i) delete [] m_Blocks[i];
+	m_Blocks.clear();
+	m_Cur = nullptr;
+	m_Left = 0;
+	m_Reserved = 0;
+}
+
+size_t Arena::getReserved(){return m_Reserved;}
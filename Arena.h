@@ -0,0 +1,27 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <cstddef>
+#include <vector>
+
+// Bump allocator: alloc() carves from large blocks, everything is freed at once
+class Arena{
+private:
+	std::vector<char*> m_Blocks;  // owned blocks
+	char* m_Cur;                  // next free byte in the current block
+	size_t m_Left;                // bytes left in the current block
+	size_t m_Reserved;            // total bytes of all blocks
+
+public:
+	Arena();
+	~Arena();
+
+	// 8-byte aligned storage, valid until release()/destruction
+	void* alloc(size_t bytes);
+	// drop every block in one go
+	void release();
+
+	size_t getReserved();
+};
+
+#endif
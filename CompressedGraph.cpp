@@ -0,0 +1,164 @@
+#include "CompressedGraph.h"
+#include <iostream>
+#include <utility>
+#include <algorithm>
+
+// ---------- varint helpers ----------
+static void putVarint(std::vector<unsigned char>& out, uint64_t x)
+{
+	while(x >= 0x80) {
+		out.push_back((unsigned char)(x | 0x80));
+		x >>= 7;
+	}
+	out.push_back((unsigned char)x);
+}
+
+// small negative weights stay short
+static uint64_t zigzag(int w) { return (uint64_t)(((uint32_t)w << 1) ^ (uint32_t)(w >> 31)); }
+
+// encode rows; rows[k] = (row, original id of neighbor, weight), grouped by row, ascending id
+static void encodeRows(int n, const std::vector<Edge>& rows,
+	std::vector<unsigned char>& ids, std::vector<unsigned char>& wts,
+	std::vector<uint64_t>& idOff, std::vector<uint64_t>& wtOff, std::vector<int>& deg)
+{
+	ids.clear(); wts.clear();
+	idOff.assign(n + 1, 0);
+	wtOff.assign(n + 1, 0);
+	deg.assign(n, 0);
+	size_t k = 0;
+	for(int u = 0; u < n; ++u) {
+		idOff[u] = ids.size();
+		wtOff[u] = wts.size();
+		int prev = 0;
+		for(; k < rows.size() && rows[k].u == u; ++k) {
+			putVarint(ids, (uint64_t)(rows[k].v - prev));
+			putVarint(wts, zigzag(rows[k].w));
+			prev = rows[k].v;
+			deg[u]++;
+		}
+	}
+	idOff[n] = ids.size();
+	wtOff[n] = wts.size();
+	ids.shrink_to_fit();
+	wts.shrink_to_fit();
+}
+
+CompressedGraph::CompressedGraph(bool type, int size) : Graph(type, size)
+{
+	m_IdOff.assign(m_Size + 1, 0);
+	m_WtOff.assign(m_Size + 1, 0);
+	m_Deg.assign(m_Size, 0);
+	m_HasIn = false;
+}
+
+CompressedGraph::~CompressedGraph()
+{
+
+}
+
+void CompressedGraph::build(const std::vector<Edge>& edges)
+{
+	// (internal row, original neighbor id), stable so a repeated edge keeps its last weight
+	std::vector<Edge> rows;
+	rows.reserve(edges.size());
+	for(const auto& e : edges) {
+		if(e.u < 0 || e.u >= m_Size || e.v < 0 || e.v >= m_Size) continue;
+		rows.push_back({toInternal(e.u), e.v, e.w});
+	}
+	std::stable_sort(rows.begin(), rows.end(), [](const Edge& a, const Edge& b){
+		return a.u != b.u ? a.u < b.u : a.v < b.v;
+	});
+	// drop overwritten duplicates
+	size_t m = 0;
+	for(size_t i = 0; i < rows.size(); ++i) {
+		if(m && rows[m-1].u == rows[i].u && rows[m-1].v == rows[i].v) rows[m-1].w = rows[i].w;
+		else rows[m++] = rows[i];
+	}
+	rows.resize(m);
+
+	for(const auto& r : rows) noteInsert(r.u, toInternal(r.v), r.w);
+	encodeRows(m_Size, rows, m_Ids, m_Wts, m_IdOff, m_WtOff, m_Deg);
+	m_HasIn = false;
+}
+
+// transpose of the out rows, same encoding
+void CompressedGraph::buildIncoming()
+{
+	std::vector<Edge> rows;
+	rows.reserve(m_EdgeCount);
+	std::vector<std::pair<int,int>> out;
+	for(int u = 0; u < m_Size; ++u) {
+		getOutEdges(u, &out);
+		for(const auto& kv : out) rows.push_back({kv.first, toOrig(u), kv.second});
+	}
+	std::sort(rows.begin(), rows.end(), [](const Edge& a, const Edge& b){
+		return a.u != b.u ? a.u < b.u : a.v < b.v;
+	});
+	encodeRows(m_Size, rows, m_InIds, m_InWts, m_InIdOff, m_InWtOff, m_InDeg);
+	m_HasIn = true;
+}
+
+// decode row u: (internal neighbor, weight) ascending original id
+void CompressedGraph::getOutEdges(int vertex, std::vector<std::pair<int, int>>* out)
+{
+	out->clear();
+	if(vertex < 0 || vertex >= m_Size) return;
+	const unsigned char* p = m_Ids.data() + m_IdOff[vertex];
+	const unsigned char* q = m_Wts.data() + m_WtOff[vertex];
+	out->reserve(m_Deg[vertex]);
+	int id = 0;
+	for(int k = 0; k < m_Deg[vertex]; ++k) {
+		id += (int)getVarint(p);
+		out->push_back(std::make_pair(toInternal(id), unzigzag(getVarint(q))));
+	}
+}
+
+void CompressedGraph::getAdjacentEdgesDirect(int vertex, std::map<int, int>* out) // directed view
+{
+	out->clear();
+	std::vector<std::pair<int,int>> row;
+	getOutEdges(vertex, &row);
+	for(const auto& kv : row) (*out)[kv.first] = kv.second;
+}
+
+void CompressedGraph::getAdjacentEdges(int vertex, std::map<int, int>* out) // undirect view
+{
+	getAdjacentEdgesDirect(vertex, out);
+	if(vertex < 0 || vertex >= m_Size) return;
+	if(!m_HasIn) buildIncoming();
+
+	// incoming neighbor, keep the smaller weight of both directions
+	const unsigned char* p = m_InIds.data() + m_InIdOff[vertex];
+	const unsigned char* q = m_InWts.data() + m_InWtOff[vertex];
+	int id = 0;
+	for(int k = 0; k < m_InDeg[vertex]; ++k) {
+		id += (int)getVarint(p);
+		int u = toInternal(id), w = unzigzag(getVarint(q));
+		auto it = out->find(u);
+		if(it == out->end()) (*out)[u] = w;
+		else it->second = std::min(it->second, w);
+	}
+}
+
+void CompressedGraph::insertEdge(int from, int to, int weight)
+{
+	// read-only backend, edges come from build()
+	(void)from; (void)to; (void)weight;
+}
+
+// transpose buffer + in rows about the size of the out rows
+size_t CompressedGraph::getPendingUndirectedBytes()
+{
+	if(m_HasIn) return 0;
+	return (size_t)m_EdgeCount * sizeof(Edge) + m_Ids.size() + m_Wts.size() + (m_Size + 1) * 2 * sizeof(uint64_t) + m_Size * sizeof(int);
+}
+
+size_t CompressedGraph::getMemoryBytes()
+{
+	size_t b = Graph::getMemoryBytes();
+	b += m_Ids.capacity() + m_Wts.capacity();
+	b += (m_IdOff.capacity() + m_WtOff.capacity()) * sizeof(uint64_t) + m_Deg.capacity() * sizeof(int);
+	b += m_InIds.capacity() + m_InWts.capacity();
+	b += (m_InIdOff.capacity() + m_InWtOff.capacity()) * sizeof(uint64_t) + m_InDeg.capacity() * sizeof(int);
+	return b;
+}
@@ -0,0 +1,88 @@
+#ifndef _COMPRESSED_H_
+#define _COMPRESSED_H_
+
+#include "Graph.h"
+#include <stdint.h>
+
+// varint / zigzag decoding, inline for the kernels
+inline uint64_t getVarint(const unsigned char*& p)
+{
+	uint64_t x = 0;
+	int shift = 0;
+	while(*p & 0x80) {
+		x |= (uint64_t)(*p++ & 0x7f) << shift;
+		shift += 7;
+	}
+	x |= (uint64_t)(*p++) << shift;
+	return x;
+}
+inline int unzigzag(uint64_t x) { return (int)((uint32_t)(x >> 1) ^ (uint32_t)(-(int32_t)(x & 1))); }
+
+// Read-only adjacency list, compressed:
+//  - neighbor ids of each row sorted by original id, stored as varint deltas
+//  - weights zigzag + varint in a separate stream
+// Rows are decoded on the fly by every accessor.
+class CompressedGraph : public Graph{
+private:
+	std::vector<unsigned char> m_Ids;   // delta-coded neighbor ids, row after row
+	std::vector<unsigned char> m_Wts;   // zigzag-coded weights, row after row
+	std::vector<uint64_t> m_IdOff;      // row u = m_Ids[m_IdOff[u] .. m_IdOff[u+1])
+	std::vector<uint64_t> m_WtOff;
+	std::vector<int> m_Deg;             // edges per row
+
+	// incoming rows, same encoding, built on the first undirected query
+	std::vector<unsigned char> m_InIds, m_InWts;
+	std::vector<uint64_t> m_InIdOff, m_InWtOff;
+	std::vector<int> m_InDeg;
+	bool m_HasIn;
+
+	void buildIncoming();
+
+	// decoder over one encoded row
+	struct Cursor {
+		const unsigned char* p;
+		const unsigned char* q;
+		int left, id, w;
+		Cursor(const unsigned char* ids, const unsigned char* wts, int deg) : p(ids), q(wts), left(deg), id(0), w(0) { next(); }
+		void next() {
+			if(left-- <= 0) return;
+			id += (int)getVarint(p);
+			w = unzigzag(getVarint(q));
+		}
+		bool done() const { return left < 0; }
+	};
+
+public:
+	CompressedGraph(bool type, int size);
+	~CompressedGraph();
+
+	// Encode the whole edge set (original ids); call once, after setOrder if relabeled
+	void build(const std::vector<Edge>& edges);
+
+	void getAdjacentEdges(int vertex, std::map<int, int>* m) override;
+	void getAdjacentEdgesDirect(int vertex, std::map<int, int>* m) override;
+	void getOutEdges(int vertex, std::vector<std::pair<int, int>>* out) override;
+	void insertEdge(int from, int to, int weight) override;   // read-only: ignored
+	bool isReadOnly() override { return true; }
+	size_t getMemoryBytes() override;
+	size_t getPendingUndirectedBytes() override;
+
+	// Static iteration for the kernels in GraphMethod.cpp: f(v, w), ascending original id
+	template<class F> void forEachOut(int u, F f) {
+		for(Cursor a(m_Ids.data() + m_IdOff[u], m_Wts.data() + m_WtOff[u], m_Deg[u]); !a.done(); a.next())
+			f(toInternal(a.id), a.w);
+	}
+	// merge of the out row and the in row, both sorted by original id
+	template<class F> void forEachUndir(int u, F f) {
+		if(!m_HasIn) buildIncoming();
+		Cursor a(m_Ids.data() + m_IdOff[u], m_Wts.data() + m_WtOff[u], m_Deg[u]);
+		Cursor b(m_InIds.data() + m_InIdOff[u], m_InWts.data() + m_InWtOff[u], m_InDeg[u]);
+		while(!a.done() || !b.done()) {
+			if(b.done() || (!a.done() && a.id < b.id)) { f(toInternal(a.id), a.w); a.next(); }
+			else if(a.done() || b.id < a.id) { f(toInternal(b.id), b.w); b.next(); }
+			else { f(toInternal(a.id), a.w < b.w ? a.w : b.w); a.next(); b.next(); }
+		}
+	}
+};
+
+#endif
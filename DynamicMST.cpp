@@ -0,0 +1,204 @@
+#include "DynamicMST.h"
+#include "Stats.h"
+
+DynamicMST::DynamicMST()
+{
+	m_N = 0;
+	m_Valid = false;
+	m_Gen = 0;
+	m_Cost = 0;
+	m_HasTree = false;
+}
+
+void DynamicMST::build(int n, const std::vector<Edge>& tree, unsigned gen)
+{
+	clear();
+	m_N = n;
+	m_Edges = tree;
+	for(size_t i = 0; i < m_Edges.size(); ++i) {
+		m_Slot[std::make_pair(m_Edges[i].u, m_Edges[i].v)] = (int)i;
+		m_Cost += m_Edges[i].w;
+	}
+	m_Gen = gen;
+	m_Valid = true;
+}
+
+void DynamicMST::clear()
+{
+	m_Valid = false;
+	m_Cost = 0;
+	std::vector<Edge>().swap(m_Edges);
+	m_Slot.clear();
+	for(int k = 0; k < 2; ++k) std::vector<int>().swap(m_Ch[k]);
+	std::vector<int>().swap(m_Par);
+	std::vector<int>().swap(m_Agg);
+	std::vector<char>().swap(m_Rev);
+	std::vector<int>().swap(m_Path);
+	m_HasTree = false;
+}
+
+size_t DynamicMST::getMemoryBytes()
+{
+	size_t links = (m_Ch[0].capacity() + m_Ch[1].capacity() + m_Par.capacity() + m_Agg.capacity()) * sizeof(int);
+	return m_Edges.capacity() * sizeof(Edge) + m_Slot.size() * SLOT_NODE_BYTES + links + m_Rev.capacity();
+}
+
+// ---------- link-cut tree ----------
+bool DynamicMST::heavier(int x, int y)
+{
+	const Edge& a = m_Edges[x - m_N];
+	const Edge& b = m_Edges[y - m_N];
+	if(a.w != b.w) return a.w > b.w;
+	if(a.u != b.u) return a.u > b.u;
+	return a.v > b.v;
+}
+
+bool DynamicMST::isSplayRoot(int x)
+{
+	int p = m_Par[x];
+	return p < 0 || (m_Ch[0][p] != x && m_Ch[1][p] != x);
+}
+
+void DynamicMST::pull(int x)
+{
+	int best = x >= m_N ? x : -1;   // vertex nodes carry no edge
+	for(int k = 0; k < 2; ++k) {
+		int c = m_Ch[k][x];
+		if(c < 0 || m_Agg[c] < 0) continue;
+		if(best < 0 || heavier(m_Agg[c], best)) best = m_Agg[c];
+	}
+	m_Agg[x] = best;
+}
+
+// lazy subtree reversal (makeRoot)
+void DynamicMST::push(int x)
+{
+	if(!m_Rev[x]) return;
+	std::swap(m_Ch[0][x], m_Ch[1][x]);
+	for(int k = 0; k < 2; ++k) if(m_Ch[k][x] >= 0) m_Rev[m_Ch[k][x]] ^= 1;
+	m_Rev[x] = 0;
+}
+
+void DynamicMST::rotate(int x)
+{
+	int p = m_Par[x], g = m_Par[p];
+	int k = m_Ch[1][p] == x ? 1 : 0;
+	if(!isSplayRoot(p)) m_Ch[m_Ch[1][g] == p ? 1 : 0][g] = x;
+	m_Par[x] = g;
+	m_Ch[k][p] = m_Ch[!k][x];
+	if(m_Ch[!k][x] >= 0) m_Par[m_Ch[!k][x]] = p;
+	m_Ch[!k][x] = p;
+	m_Par[p] = x;
+	pull(p);
+	pull(x);
+}
+
+void DynamicMST::splay(int x)
+{
+	// push pending reversals top-down first
+	m_Path.clear();
+	m_Path.push_back(x);
+	for(int y = x; !isSplayRoot(y); y = m_Par[y]) m_Path.push_back(m_Par[y]);
+	for(size_t i = m_Path.size(); i-- > 0; ) push(m_Path[i]);
+
+	while(!isSplayRoot(x)) {
+		int p = m_Par[x], g = m_Par[p];
+		if(!isSplayRoot(p)) rotate((m_Ch[0][g] == p) == (m_Ch[0][p] == x) ? p : x);
+		rotate(x);
+	}
+}
+
+void DynamicMST::access(int x)
+{
+	for(int last = -1, y = x; y >= 0; last = y, y = m_Par[y]) {
+		splay(y);
+		m_Ch[1][y] = last;
+		pull(y);
+	}
+	splay(x);
+}
+
+void DynamicMST::makeRoot(int x)
+{
+	access(x);
+	m_Rev[x] ^= 1;
+}
+
+void DynamicMST::link(int x, int y)
+{
+	makeRoot(x);
+	m_Par[x] = y;
+}
+
+// x and y adjacent in the represented tree
+void DynamicMST::cut(int x, int y)
+{
+	makeRoot(x);
+	access(y);
+	m_Ch[0][y] = -1;
+	m_Par[x] = -1;
+	pull(y);
+}
+
+// largest edge node on the tree path x..y
+int DynamicMST::pathMax(int x, int y)
+{
+	makeRoot(x);
+	access(y);
+	return m_Agg[y];
+}
+
+void DynamicMST::buildTree()
+{
+	int total = m_N + (int)m_Edges.size();
+	for(int k = 0; k < 2; ++k) m_Ch[k].assign(total, -1);
+	m_Par.assign(total, -1);
+	m_Agg.assign(total, -1);
+	m_Rev.assign(total, 0);
+	for(int x = m_N; x < total; ++x) m_Agg[x] = x;
+	for(size_t i = 0; i < m_Edges.size(); ++i) {
+		int e = m_N + (int)i;
+		link(m_Edges[i].u, e);
+		link(e, m_Edges[i].v);
+	}
+	m_HasTree = true;
+}
+
+// ---------- updates ----------
+void DynamicMST::lower(int a, int b, int w)
+{
+	if(!m_Valid || a == b) return;   // a self-loop never joins the tree
+	if(a > b) std::swap(a, b);
+	if(!m_HasTree) buildTree();
+
+	auto it = m_Slot.find(std::make_pair(a, b));
+	if(it != m_Slot.end()) {
+		// tree edge got cheaper: still the minimum tree, only its key moves
+		int e = m_N + it->second;
+		access(e);
+		m_Cost += (long long)w - m_Edges[it->second].w;
+		m_Edges[it->second].w = w;
+		pull(e);
+		return;
+	}
+
+	// non-tree pair: swap with the heaviest edge of the cycle it closes
+	int m = pathMax(a, b);
+	if(m < 0) return;
+	int slot = m - m_N;
+	Edge cand = {a, b, w};
+	const Edge& old = m_Edges[slot];
+	bool lighter = cand.w != old.w ? cand.w < old.w : (cand.u != old.u ? cand.u < old.u : cand.v < old.v);
+	if(!lighter) return;
+
+	STAT_INC(relaxed);
+	cut(old.u, m);
+	cut(m, old.v);
+	m_Slot.erase(std::make_pair(old.u, old.v));
+	m_Cost += (long long)w - old.w;
+	m_Edges[slot] = cand;   // node m is reused for the new edge
+	m_Slot[std::make_pair(a, b)] = slot;
+	m_Agg[m] = m;
+	link(a, m);
+	link(m, b);
+}
@@ -0,0 +1,66 @@
+#ifndef _DYNAMICMST_H_
+#define _DYNAMICMST_H_
+
+#include "Graph.h"
+
+// Minimum spanning tree kept between commands: written by KRUSKAL, maintained
+// under INSERT / UPDATE. Original ids, pairs stored as (a, b) with a < b.
+// Edges are ordered by (w, a, b) like Kruskal() breaks ties, so the tree is
+// unique and always prints exactly what a fresh KRUSKAL would.
+//
+// Lowering a pair's weight changes the tree by at most one swap: the pair
+// replaces the largest edge on the tree path between its ends. That path
+// maximum comes from a link-cut tree (edges are nodes n.., vertices 0..n-1),
+// built on the first update, O(log n) amortized per update.
+class DynamicMST{
+private:
+	int m_N;
+	bool m_Valid;
+	unsigned m_Gen;                   // Graph::getGeneration() the tree is current for
+	long long m_Cost;
+	std::vector<Edge> m_Edges;        // tree edge slots, slot i = link-cut node n+i
+	std::map<std::pair<int,int>, int> m_Slot;   // (a, b) -> slot
+
+	// link-cut tree over m_N + m_Edges.size() nodes
+	std::vector<int> m_Ch[2], m_Par, m_Agg;   // m_Agg: node with the largest edge in the splay subtree
+	std::vector<char> m_Rev;
+	std::vector<int> m_Path;          // splay scratch: node-to-root path, reused
+	bool m_HasTree;
+
+	bool heavier(int x, int y);      // edge node x after edge node y in (w, a, b) order
+	bool isSplayRoot(int x);
+	void pull(int x);
+	void push(int x);
+	void rotate(int x);
+	void splay(int x);
+	void access(int x);
+	void makeRoot(int x);
+	void link(int x, int y);
+	void cut(int x, int y);
+	int pathMax(int x, int y);
+	void buildTree();
+
+public:
+	DynamicMST();
+
+	// Kruskal result: n-1 edges (a <= b) in original ids
+	void build(int n, const std::vector<Edge>& tree, unsigned gen);
+	void clear();
+	bool isCurrent(unsigned gen) { return m_Valid && m_Gen == gen; }
+	bool isValid() { return m_Valid; }
+	void setGeneration(unsigned gen) { m_Gen = gen; }
+
+	// undirected weight of pair {a, b} is now w, and w is lower than before (or the pair is new)
+	void lower(int a, int b, int w);
+
+	// tree slots, pair index and link-cut arrays
+	size_t getMemoryBytes();
+	// one m_Slot entry: the value plus a red-black node header (color, parent, two children)
+	static const size_t SLOT_NODE_BYTES = sizeof(std::pair<const std::pair<int,int>, int>) + 4 * sizeof(void*);
+
+	int getSize() { return m_N; }
+	long long getCost() { return m_Cost; }
+	const std::vector<Edge>& getEdges() { return m_Edges; }
+};
+
+#endif
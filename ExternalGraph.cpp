@@ -0,0 +1,294 @@
+#include "ExternalGraph.h"
+#include "Stats.h"
+#include <algorithm>
+#include <utility>
+
+// runs merged in one pass (open files, one read buffer each)
+static const size_t EDGE_SORT_FANIN = 64;
+// records per write when a merge pass fills a new run
+static const size_t EDGE_SORT_WRITE_RECS = 4096;
+
+// stdio buffer of the graph's temp files, scaled to the budget
+static size_t tempBufferBytes(size_t budget)
+{
+	return std::min<size_t>(std::max<size_t>(budget / 16, 4096), 1u << 20);
+}
+
+// anonymous temp file (removed on fclose / exit); buffer 0 = unbuffered,
+// for sort runs that are only written and read in whole blocks
+static FILE* openTemp(size_t buffer)
+{
+	FILE* f = tmpfile();
+	if(!f) return nullptr;
+	if(buffer) setvbuf(f, nullptr, _IOFBF, buffer);
+	else setvbuf(f, nullptr, _IONBF, 0);
+	return f;
+}
+
+static bool byRowCol(const Edge& a, const Edge& b)
+{
+	return a.u != b.u ? a.u < b.u : a.v < b.v;
+}
+
+// parallel pairs of the mirrored view: smallest weight first
+static bool byRowColWeight(const Edge& a, const Edge& b)
+{
+	if(a.u != b.u) return a.u < b.u;
+	if(a.v != b.v) return a.v < b.v;
+	return a.w < b.w;
+}
+
+// ---------- EdgeSorter ----------
+EdgeSorter::EdgeSorter(Less less, size_t budget)
+{
+	m_Less = less;
+	m_BlockCap = std::max<size_t>(budget / sizeof(Edge), 1024);
+	m_Failed = false;
+}
+
+EdgeSorter::~EdgeSorter()
+{
+	for(FILE* f : m_Runs) if(f) fclose(f);
+}
+
+void EdgeSorter::push(const Edge& e)
+{
+	if(m_Block.size() >= m_BlockCap) flushBlock();
+	// grow by doubling, but never past one block
+	if(m_Block.size() == m_Block.capacity())
+		m_Block.reserve(std::min(m_BlockCap, std::max<size_t>(1024, 2 * m_Block.capacity())));
+	m_Block.push_back(e);
+}
+
+// sorted block -> new run
+void EdgeSorter::flushBlock()
+{
+	std::stable_sort(m_Block.begin(), m_Block.end(), m_Less);
+	FILE* f = openTemp(0);
+	if(!f || fwrite(m_Block.data(), sizeof(Edge), m_Block.size(), f) != m_Block.size()) {
+		m_Failed = true;
+		if(f) fclose(f);
+	}else{
+		rewind(f);
+		m_Runs.push_back(f);
+	}
+	m_Block.clear();
+}
+
+bool EdgeSorter::finish(const std::function<void(const Edge&)>& sink)
+{
+	// everything fit in one block: no I/O at all
+	if(m_Runs.empty() && !m_Failed) {
+		std::stable_sort(m_Block.begin(), m_Block.end(), m_Less);
+		for(const auto& e : m_Block) sink(e);
+		std::vector<Edge>().swap(m_Block);
+		return true;
+	}
+	if(!m_Block.empty()) flushBlock();
+	std::vector<Edge>().swap(m_Block);   // the read buffers take over the budget
+
+	// intermediate passes until one merge can take every run
+	while(!m_Failed && m_Runs.size() > EDGE_SORT_FANIN) {
+		std::vector<FILE*> next;
+		for(size_t i = 0; i < m_Runs.size(); i += EDGE_SORT_FANIN) {
+			size_t last = std::min(i + EDGE_SORT_FANIN, m_Runs.size());
+			FILE* f = openTemp(0);
+			if(!f) { m_Failed = true; break; }
+			bool wrote = true;
+			std::vector<Edge> out;
+			out.reserve(EDGE_SORT_WRITE_RECS);
+			auto drain = [f, &out, &wrote](){
+				if(fwrite(out.data(), sizeof(Edge), out.size(), f) != out.size()) wrote = false;
+				out.clear();
+			};
+			if(!merge(i, last, [&](const Edge& e){
+				out.push_back(e);
+				if(out.size() == EDGE_SORT_WRITE_RECS) drain();
+			})) m_Failed = true;
+			drain();
+			if(!wrote) m_Failed = true;
+			rewind(f);
+			next.push_back(f);
+		}
+		for(FILE* f : m_Runs) if(f) fclose(f);
+		m_Runs.swap(next);
+	}
+	if(m_Failed) return false;
+	return merge(0, m_Runs.size(), sink);
+}
+
+// k-way merge of runs [first, last) into sink; equal keys in run order. Closes the runs.
+bool EdgeSorter::merge(size_t first, size_t last, const std::function<void(const Edge&)>& sink)
+{
+	struct Reader {
+		FILE* f;
+		std::vector<Edge> buf;
+		size_t pos, len;
+		bool fill() {
+			len = fread(buf.data(), sizeof(Edge), buf.size(), f);
+			pos = 0;
+			return len > 0;
+		}
+	};
+	size_t k = last - first;
+	size_t bufRecs = std::max<size_t>(256, m_BlockCap / (k + 1));
+	std::vector<Reader> rd(k);
+	std::vector<int> heap;
+	for(size_t i = 0; i < k; ++i) {
+		rd[i].f = m_Runs[first + i];
+		rd[i].buf.resize(bufRecs);
+		if(rd[i].fill()) heap.push_back((int)i);
+	}
+	// min-heap on (record, run index)
+	auto greater = [this, &rd](int a, int b){
+		const Edge& x = rd[a].buf[rd[a].pos];
+		const Edge& y = rd[b].buf[rd[b].pos];
+		if(m_Less(y, x)) return true;
+		if(m_Less(x, y)) return false;
+		return a > b;
+	};
+	std::make_heap(heap.begin(), heap.end(), greater);
+	while(!heap.empty()) {
+		std::pop_heap(heap.begin(), heap.end(), greater);
+		int i = heap.back();
+		sink(rd[i].buf[rd[i].pos]);
+		if(++rd[i].pos < rd[i].len || rd[i].fill()) std::push_heap(heap.begin(), heap.end(), greater);
+		else heap.pop_back();
+	}
+	bool ok = true;
+	for(size_t i = 0; i < k; ++i) {
+		if(ferror(rd[i].f)) ok = false;
+		fclose(rd[i].f);
+		m_Runs[first + i] = nullptr;
+	}
+	return ok;
+}
+
+// ---------- ExternalGraph ----------
+ExternalGraph::ExternalGraph(bool type, int size, size_t budget) : Graph(type, size)
+{
+	m_Budget = budget;
+	m_Loader = new EdgeSorter(byRowCol, budget);
+	m_Out = nullptr;
+	m_Undir = nullptr;
+	m_OutOff.assign(m_Size + 1, 0);
+}
+
+ExternalGraph::~ExternalGraph()
+{
+	delete m_Loader;
+	if(m_Out) fclose(m_Out);
+	if(m_Undir) fclose(m_Undir);
+}
+
+void ExternalGraph::addEdge(int from, int to, int weight)
+{
+	if(!m_Loader) return;
+	if(from < 0 || from >= m_Size || to < 0 || to >= m_Size) return;
+	m_Loader->push({from, to, weight});
+}
+
+// sorted input -> out file + row offsets; duplicates keep the last weight
+bool ExternalGraph::seal()
+{
+	if(!m_Loader) return false;
+	m_Out = openTemp(tempBufferBytes(m_Budget));
+	if(!m_Out) return false;
+
+	bool ok = true;
+	bool has = false;
+	Edge pend = {0, 0, 0};
+	auto emit = [this, &ok](const Edge& e){
+		if(fwrite(&e, sizeof(Edge), 1, m_Out) != 1) ok = false;
+		m_OutOff[e.u + 1]++;
+		noteInsert(e.u, e.v, e.w);
+	};
+	bool sorted = m_Loader->finish([&](const Edge& e){
+		if(has && pend.u == e.u && pend.v == e.v) { pend.w = e.w; return; }
+		if(has) emit(pend);
+		pend = e;
+		has = true;
+	});
+	if(has) emit(pend);
+	for(int u = 0; u < m_Size; ++u) m_OutOff[u + 1] += m_OutOff[u];
+
+	delete m_Loader;
+	m_Loader = nullptr;
+	return sorted && ok && fflush(m_Out) == 0;
+}
+
+// out edges mirrored, external sort by (row, col, weight), parallel pairs keep the min weight.
+// Installed only when complete; false on an I/O error, like seal()
+bool ExternalGraph::buildUndirected()
+{
+	FILE* f = openTemp(tempBufferBytes(m_Budget));
+	if(!f) return false;
+
+	EdgeSorter s(byRowColWeight, m_Budget);
+	noteWorkBytes(m_Budget);   // sort block / merge buffers
+	scanOut([&s](const Edge& e){
+		s.push(e);
+		if(e.u != e.v) s.push({e.v, e.u, e.w});
+	});
+	std::vector<uint64_t> off(m_Size + 1, 0);
+	bool ok = true;
+	bool has = false;
+	Edge prev = {0, 0, 0};
+	bool sorted = s.finish([&](const Edge& e){
+		// first of a run is the smallest weight
+		if(has && prev.u == e.u && prev.v == e.v) return;
+		if(fwrite(&e, sizeof(Edge), 1, f) != 1) ok = false;
+		off[e.u + 1]++;
+		prev = e;
+		has = true;
+	});
+	if(!sorted || !ok || fflush(f) != 0) {
+		fclose(f);
+		return false;
+	}
+	for(int u = 0; u < m_Size; ++u) off[u + 1] += off[u];
+	m_Undir = f;
+	m_UndirOff.swap(off);
+	return true;
+}
+
+void ExternalGraph::getAdjacentEdgesDirect(int vertex, std::map<int, int>* out) // directed view
+{
+	out->clear();
+	if(vertex < 0 || vertex >= m_Size) return;
+	forEachOut(vertex, [out](int v, int w){ (*out)[v] = w; });
+}
+
+void ExternalGraph::getAdjacentEdges(int vertex, std::map<int, int>* out) // undirect view
+{
+	out->clear();
+	if(vertex < 0 || vertex >= m_Size) return;
+	forEachUndir(vertex, [out](int v, int w){ (*out)[v] = w; });
+}
+
+void ExternalGraph::getOutEdges(int vertex, std::vector<std::pair<int, int>>* out)
+{
+	out->clear();
+	if(vertex < 0 || vertex >= m_Size) return;
+	forEachOut(vertex, [out](int v, int w){ out->push_back(std::make_pair(v, w)); });
+}
+
+void ExternalGraph::insertEdge(int from, int to, int weight)
+{
+	// read-only backend, edges come from addEdge() + seal()
+	(void)from; (void)to; (void)weight;
+}
+
+// one external sort (its block budget) + the row offsets
+size_t ExternalGraph::getPendingUndirectedBytes()
+{
+	if(!m_UndirOff.empty()) return 0;
+	return m_Budget + (m_Size + 1) * sizeof(uint64_t) + tempBufferBytes(m_Budget);
+}
+
+// RAM only: the edges themselves live in the temp files, only their stdio buffers count
+size_t ExternalGraph::getMemoryBytes()
+{
+	size_t files = ((m_Out ? 1 : 0) + (m_Undir ? 1 : 0)) * tempBufferBytes(m_Budget);
+	return Graph::getMemoryBytes() + (m_OutOff.capacity() + m_UndirOff.capacity()) * sizeof(uint64_t) + files;
+}
@@ -0,0 +1,109 @@
+#ifndef _EXTERNAL_H_
+#define _EXTERNAL_H_
+
+#include "Graph.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <functional>
+
+// sort blocks / read buffers when no MEMLIMIT is set
+const size_t EXTERNAL_DEFAULT_BUDGET = 64u << 20;
+
+// External merge sort of Edge records.
+// push() fills one block of budget bytes; a full block is sorted and written as a run,
+// finish() merges the runs (at most EDGE_SORT_FANIN at a time) and streams the result.
+// Equal keys come out in push order (stable).
+class EdgeSorter{
+public:
+	typedef bool (*Less)(const Edge& a, const Edge& b);
+
+	EdgeSorter(Less less, size_t budget);
+	~EdgeSorter();
+
+	void push(const Edge& e);
+	// sink(e) for every record in sorted order; false on an I/O error
+	bool finish(const std::function<void(const Edge&)>& sink);
+
+private:
+	Less m_Less;
+	size_t m_BlockCap;             // records per run
+	std::vector<Edge> m_Block;
+	std::vector<FILE*> m_Runs;     // sorted runs, oldest first
+	bool m_Failed;
+
+	void flushBlock();
+	bool merge(size_t first, size_t last, const std::function<void(const Edge&)>& sink);
+};
+
+// Read-only adjacency kept on disk, for edge sets larger than RAM.
+//  - out edges as raw Edge records sorted by (u, v), in an anonymous temp file
+//  - row offsets in memory: O(n) RAM, O(m) disk (semi-external)
+//  - undirected view (mirrored, min weight per pair) written on the first undirected query
+// No relabeling: internal ids are original ids.
+class ExternalGraph : public Graph{
+private:
+	size_t m_Budget;                  // bytes for sort blocks and read buffers
+	EdgeSorter* m_Loader;             // LOAD input, until seal()
+	FILE* m_Out;
+	std::vector<uint64_t> m_OutOff;   // row u = records [m_OutOff[u], m_OutOff[u+1])
+	FILE* m_Undir;
+	std::vector<uint64_t> m_UndirOff;
+
+	bool buildUndirected();
+
+	// records [from, to) of f, in chunks through a small stack buffer
+	template<class F> static void scanRange(FILE* f, uint64_t from, uint64_t to, F fn) {
+		if(!f || from >= to) return;
+		Edge buf[256];
+		fseeko(f, (off_t)(from * sizeof(Edge)), SEEK_SET);
+		while(from < to) {
+			size_t k = (size_t)std::min<uint64_t>(256, to - from);
+			k = fread(buf, sizeof(Edge), k, f);
+			if(k == 0) break;
+			for(size_t i = 0; i < k; ++i) fn(buf[i]);
+			from += k;
+		}
+	}
+
+public:
+	ExternalGraph(bool type, int size, size_t budget);
+	~ExternalGraph();
+
+	// LOAD: stream every edge in (original ids), then seal() sorts them onto disk.
+	// A repeated edge keeps its last weight. false on an I/O error.
+	void addEdge(int from, int to, int weight);
+	bool seal();
+
+	size_t getBudget() { return m_Budget; }
+
+	// undirected view, written on first use; false on an I/O error (the view
+	// stays unbuilt and reads empty, so callers check this before relying on it)
+	bool prepareUndirected() { return !m_UndirOff.empty() || buildUndirected(); }
+
+	void getAdjacentEdges(int vertex, std::map<int, int>* m) override;
+	void getAdjacentEdgesDirect(int vertex, std::map<int, int>* m) override;
+	void getOutEdges(int vertex, std::vector<std::pair<int, int>>* out) override;
+	void insertEdge(int from, int to, int weight) override;   // read-only: ignored
+	bool isReadOnly() override { return true; }
+	size_t getMemoryBytes() override;
+	size_t getPendingUndirectedBytes() override;
+
+	// Row reads for the kernels in GraphMethod.cpp: f(v, w), ascending id, one seek per row
+	template<class F> void forEachOut(int u, F f) {
+		scanRange(m_Out, m_OutOff[u], m_OutOff[u + 1], [&f](const Edge& e){ f(e.v, e.w); });
+	}
+	template<class F> void forEachUndir(int u, F f) {
+		if(!prepareUndirected()) return;
+		scanRange(m_Undir, m_UndirOff[u], m_UndirOff[u + 1], [&f](const Edge& e){ f(e.v, e.w); });
+	}
+
+	// Sequential pass over the whole view, (u, v) order: f(edge)
+	template<class F> void scanOut(F f) { scanRange(m_Out, 0, m_OutOff[m_Size], f); }
+	template<class F> void scanUndir(F f) {
+		if(!prepareUndirected()) return;
+		scanRange(m_Undir, 0, m_UndirOff[m_Size], f);
+	}
+};
+
+#endif
@@ -1,10 +1,31 @@
 #include "Graph.h"
+#include "Stats.h"
+#include <limits>
+
+// largest component reachability matrix kept (bits); beyond it only the id order prunes
+static const size_t REACH_MAX_BYTES = 16u << 20;
 
 // store flag
 Graph::Graph(bool type, int size)
 {
 	m_Type = type;
 	m_Size = size;
+	m_Format = 'L';
+
+	m_EdgeCount = 0;
+	m_SelfLoops = 0;
+	m_NegEdges = 0;
+	m_MinWeight = std::numeric_limits<int>::max();
+	m_MaxWeight = std::numeric_limits<int>::min();
+
+	m_Gen = 0;
+	m_TopoGen = 0;
+	m_CompCount = 0;
+	m_CompGen = (unsigned)-1; // nothing computed yet
+	m_SccCount = 0;
+	m_SccGen = (unsigned)-1;
+	m_ReachWords = 0;
+	m_SymGen = (unsigned)-1;
 }
 
 Graph::~Graph()	
@@ -15,3 +36,350 @@ Graph::~Graph()
 // small getter
 bool Graph::getType(){return m_Type;}	
 int Graph::getSize(){return m_Size;}
+char Graph::getFormat(){return m_Format;}
+void Graph::setFormat(char format){m_Format = format;}
+
+int Graph::getEdgeCount(){return m_EdgeCount;}
+int Graph::getSelfLoopCount(){return m_SelfLoops;}
+int Graph::getNegEdgeCount(){return m_NegEdges;}
+int Graph::getMinWeight(){return m_MinWeight;}
+int Graph::getMaxWeight(){return m_MaxWeight;}
+unsigned Graph::getGeneration(){return m_Gen;}
+
+// install the permutation (toInternal[original] = internal)
+void Graph::setOrder(const std::vector<int>& toInternal)
+{
+	m_ToInternal = toInternal;
+	m_ToOrig.assign(m_Size, 0);
+	for(int o = 0; o < m_Size; ++o) m_ToOrig[toInternal[o]] = o;
+}
+
+// bookkeeping shared by every backend
+size_t Graph::getMemoryBytes()
+{
+	return (m_ToOrig.capacity() + m_ToInternal.capacity() + m_Comp.capacity() + m_SymOff.capacity() + m_Scc.capacity()) * sizeof(int)
+		+ m_SymAdj.capacity() * sizeof(AdjEntry) + m_Reach.capacity() * sizeof(uint64_t);
+}
+
+// symmetric CSR plus the mirrored edge buffer buildSymmetric sorts
+size_t Graph::getPendingUndirectedBytes()
+{
+	if(m_SymGen == m_Gen) return 0;
+	size_t m2 = 2 * (size_t)m_EdgeCount;
+	return (m_Size + 1) * sizeof(int) + m2 * (sizeof(AdjEntry) + sizeof(Edge));
+}
+
+// generic flat view through the map provider
+void Graph::getOutEdges(int vertex, std::vector<std::pair<int, int>>* out)
+{
+	std::map<int,int> m;
+	getAdjacentEdgesDirect(vertex, &m);
+	out->assign(m.begin(), m.end());
+	if(isRelabeled()) {
+		std::sort(out->begin(), out->end(), [this](const std::pair<int,int>& a, const std::pair<int,int>& b){
+			return toOrig(a.first) < toOrig(b.first);
+		});
+	}
+}
+
+// linear scan of the out row; backends with a direct lookup override it
+bool Graph::getEdge(int from, int to, int* weight)
+{
+	if(from < 0 || from >= m_Size || to < 0 || to >= m_Size) return false;
+	std::vector<std::pair<int,int>> out;
+	getOutEdges(from, &out);
+	for(const auto& kv : out) {
+		if(kv.first != to) continue;
+		*weight = kv.second;
+		return true;
+	}
+	return false;
+}
+
+bool Graph::isReadOnly(){return false;}
+
+// new edge u->v stored
+void Graph::noteInsert(int from, int to, int weight)
+{
+	m_EdgeCount++;
+	if(from == to) m_SelfLoops++;
+	if(weight < 0) m_NegEdges++;
+	m_MinWeight = std::min(m_MinWeight, weight);
+	m_MaxWeight = std::max(m_MaxWeight, weight);
+	m_Gen++;
+	m_TopoGen++;
+}
+
+// stored edge u->v dropped (overwrite calls remove + insert)
+void Graph::noteRemove(int from, int to, int weight)
+{
+	m_EdgeCount--;
+	if(from == to) m_SelfLoops--;
+	if(weight < 0) m_NegEdges--;
+	m_Gen++;
+	m_TopoGen++;
+}
+
+// weight of an existing edge changed, edge set untouched
+void Graph::noteReweight(int oldWeight, int weight)
+{
+	if(oldWeight < 0) m_NegEdges--;
+	if(weight < 0) m_NegEdges++;
+	m_MinWeight = std::min(m_MinWeight, weight);
+	m_MaxWeight = std::max(m_MaxWeight, weight);
+	m_Gen++;
+}
+
+// label components with union-find over the direct view (same connectivity as undirected)
+void Graph::buildComponents()
+{
+	std::vector<int> p(m_Size);
+	for(int i = 0; i < m_Size; ++i) p[i] = i;
+	// find with path halving
+	auto find = [&p](int x){
+		while(p[x] != x){ p[x] = p[p[x]]; x = p[x]; }
+		return x;
+	};
+
+	std::map<int,int> adj;
+	for(int u = 0; u < m_Size; ++u) {
+		getAdjacentEdgesDirect(u, &adj);
+		for(const auto& kv : adj) {
+			int a = find(u), b = find(kv.first);
+			if(a != b) p[a] = b;
+		}
+	}
+
+	// compact roots into 0..k-1
+	m_Comp.assign(m_Size, -1);
+	std::vector<int> label(m_Size, -1);
+	m_CompCount = 0;
+	for(int v = 0; v < m_Size; ++v) {
+		int r = find(v);
+		if(label[r] == -1) label[r] = m_CompCount++;
+		m_Comp[v] = label[r];
+	}
+	m_CompGen = m_TopoGen;
+}
+
+// Tarjan over a flattened copy of the direct view, then the reachability
+// bitsets bottom-up: every successor component has a smaller id, so it is complete
+void Graph::buildScc()
+{
+	std::vector<int> off(m_Size + 1, 0), adj;
+	adj.reserve(m_EdgeCount);
+	std::vector<std::pair<int,int>> out;
+	for(int u = 0; u < m_Size; ++u) {
+		getOutEdges(u, &out);
+		for(const auto& kv : out) adj.push_back(kv.first);
+		off[u + 1] = (int)adj.size();
+	}
+
+	// iterative: call holds the DFS path, pos[u] the next edge of u to look at
+	std::vector<int> index(m_Size, -1), low(m_Size, 0), pos(off.begin(), off.end() - 1);
+	std::vector<int> stk, call;
+	std::vector<char> onStk(m_Size, 0);
+	m_Scc.assign(m_Size, -1);
+	m_SccCount = 0;
+	int counter = 0;
+	auto open = [&](int v){
+		index[v] = low[v] = counter++;
+		stk.push_back(v);
+		onStk[v] = 1;
+		call.push_back(v);
+	};
+	for(int r = 0; r < m_Size; ++r) {
+		if(index[r] != -1) continue;
+		open(r);
+		while(!call.empty()) {
+			int u = call.back();
+			if(pos[u] < off[u + 1]) {
+				int v = adj[pos[u]++];
+				if(index[v] == -1) open(v);
+				else if(onStk[v]) low[u] = std::min(low[u], index[v]);
+				continue;
+			}
+			call.pop_back();
+			if(!call.empty()) low[call.back()] = std::min(low[call.back()], low[u]);
+			if(low[u] != index[u]) continue;
+			// u is the root of a component: pop it
+			int x;
+			do {
+				x = stk.back();
+				stk.pop_back();
+				onStk[x] = 0;
+				m_Scc[x] = m_SccCount;
+			} while(x != u);
+			m_SccCount++;
+		}
+	}
+
+	// the flattened view and the Tarjan arrays go away with this call
+	noteWorkBytes((off.capacity() + adj.capacity() + index.capacity() + low.capacity() + pos.capacity()
+		+ stk.capacity() + call.capacity()) * sizeof(int) + onStk.capacity());
+
+	m_ReachWords = ((size_t)m_SccCount + 63) / 64;
+	std::vector<uint64_t>().swap(m_Reach);
+	if((size_t)m_SccCount * m_ReachWords * sizeof(uint64_t) <= REACH_MAX_BYTES) {
+		// members grouped by component (counting sort)
+		std::vector<int> first(m_SccCount + 1, 0), member(m_Size);
+		for(int v = 0; v < m_Size; ++v) first[m_Scc[v] + 1]++;
+		for(int c = 0; c < m_SccCount; ++c) first[c + 1] += first[c];
+		std::vector<int> fill(first.begin(), first.end() - 1);
+		for(int v = 0; v < m_Size; ++v) member[fill[m_Scc[v]]++] = v;
+
+		m_Reach.assign((size_t)m_SccCount * m_ReachWords, 0);
+		std::vector<int> merged(m_SccCount, -1);   // successor already OR-ed into row c
+		for(int c = 0; c < m_SccCount; ++c) {
+			uint64_t* row = &m_Reach[(size_t)c * m_ReachWords];
+			row[c / 64] |= (uint64_t)1 << (c % 64);
+			for(int i = first[c]; i < first[c + 1]; ++i) {
+				int u = member[i];
+				for(int k = off[u]; k < off[u + 1]; ++k) {
+					int d = m_Scc[adj[k]];
+					if(d == c || merged[d] == c) continue;
+					merged[d] = c;
+					const uint64_t* src = &m_Reach[(size_t)d * m_ReachWords];
+					for(size_t w = 0; w < m_ReachWords; ++w) row[w] |= src[w];
+				}
+			}
+		}
+	}
+	m_SccGen = m_TopoGen;
+}
+
+// out edges mirrored, sorted by (row, original id), parallel pairs keep the min weight
+void Graph::buildSymmetric()
+{
+	std::vector<Edge> all;
+	all.reserve(2 * (size_t)m_EdgeCount);
+	std::vector<std::pair<int,int>> out;
+	for(int u = 0; u < m_Size; ++u) {
+		getOutEdges(u, &out);
+		for(const auto& kv : out) {
+			all.push_back({u, kv.first, kv.second});
+			if(kv.first != u) all.push_back({kv.first, u, kv.second});
+		}
+	}
+	std::sort(all.begin(), all.end(), [this](const Edge& a, const Edge& b){
+		if(a.u != b.u) return a.u < b.u;
+		int oa = toOrig(a.v), ob = toOrig(b.v);
+		if(oa != ob) return oa < ob;
+		return a.w < b.w;
+	});
+
+	m_SymOff.assign(m_Size + 1, 0);
+	m_SymAdj.clear();
+	m_SymAdj.reserve(all.size());
+	for(size_t i = 0; i < all.size(); ++i) {
+		// first of a run is the smallest weight
+		if(i && all[i].u == all[i-1].u && all[i].v == all[i-1].v) continue;
+		m_SymAdj.push_back({all[i].v, all[i].w});
+		m_SymOff[all[i].u + 1]++;
+	}
+	for(int u = 0; u < m_Size; ++u) m_SymOff[u + 1] += m_SymOff[u];
+	size_t reserved = m_SymAdj.capacity();
+	m_SymAdj.shrink_to_fit();
+	// transient on top of the CSR the graph keeps: the mirrored edges + the unshrunk rows
+	noteWorkBytes(all.capacity() * sizeof(Edge) + (reserved - m_SymAdj.capacity()) * sizeof(AdjEntry));
+	m_SymGen = m_Gen;
+}
+
+bool Graph::isConnected()
+{
+	if(m_Size == 0) return false;
+	return getComponentCount() == 1;
+}
+
+int Graph::getComponentCount()
+{
+	if(m_CompGen != m_TopoGen) buildComponents();
+	return m_CompCount;
+}
+
+int Graph::getComponent(int vertex)
+{
+	if(vertex < 0 || vertex >= m_Size) return -1;
+	if(m_CompGen != m_TopoGen) buildComponents();
+	return m_Comp[vertex];
+}
+
+int Graph::getSccCount()
+{
+	if(m_SccGen != m_TopoGen) buildScc();
+	return m_SccCount;
+}
+
+int Graph::getScc(int vertex)
+{
+	if(vertex < 0 || vertex >= m_Size) return -1;
+	if(m_SccGen != m_TopoGen) buildScc();
+	return m_Scc[vertex];
+}
+
+// Tarjan arrays + the flattened view + the reachability bits (at most n components)
+size_t Graph::getPendingSccBytes()
+{
+	if(m_SccGen == m_TopoGen) return 0;
+	size_t n = m_Size;
+	size_t reach = std::min(n * ((n + 63) / 64) * sizeof(uint64_t), REACH_MAX_BYTES);
+	return n * (7 * sizeof(int) + 1) + (size_t)m_EdgeCount * sizeof(int) + reach;
+}
+
+bool Graph::printGraph(ofstream *fout, const std::vector<int>* rows)
+{
+	if(m_Format == 'M') return printMatrixForm(fout, rows);
+	return printListForm(fout, rows);
+}
+
+// "[u] -> (v,w) -> ..." rows, original ids
+bool Graph::printListForm(ofstream *fout, const std::vector<int>* rows)
+{
+	if(!fout || !fout->is_open()) return false;
+
+	(*fout) << "========PRINT=======\n";
+	std::vector<std::pair<int,int>> row;
+	for(size_t k = 0; k < rowCount(rows, m_Size); ++k) {
+		int o = rowAt(rows, k);
+		getOutEdges(toInternal(o), &row);
+		(*fout) << "[" << o << "]";
+		if(!row.empty()) {
+			(*fout) << " -> ";
+			for(size_t i = 0; i < row.size(); ++i) {
+				if(i) (*fout) << " -> ";
+				(*fout) << "(" << toOrig(row[i].first) << "," << row[i].second << ")";
+			}
+		}
+		(*fout) << "\n";
+	}
+	(*fout) << "======================\n\n";
+	return true;
+}
+
+// n x n weights (0 = no edge), original ids
+bool Graph::printMatrixForm(ofstream *fout, const std::vector<int>* rows)
+{
+	if(!fout || !fout->is_open()) return false;
+
+	(*fout) << "========PRINT========\n";
+	// header
+	(*fout) << "    ";
+	for(int j = 0; j < m_Size; ++j) (*fout) << "[" << j << "] ";
+	(*fout) << "\n";
+	// rows: scatter the out edges into one dense row buffer
+	std::vector<int> dense(m_Size, 0);
+	std::vector<std::pair<int,int>> row;
+	for(size_t k = 0; k < rowCount(rows, m_Size); ++k) {
+		int i = rowAt(rows, k);
+		getOutEdges(toInternal(i), &row);
+		for(const auto& kv : row) dense[toOrig(kv.first)] = kv.second;
+		(*fout) << "[" << i << "] ";
+		for(int j = 0; j < m_Size; ++j) {
+			(*fout) << dense[j] << (j+1==m_Size? "" : "  ");
+		}
+		(*fout) << "\n";
+		for(const auto& kv : row) dense[toOrig(kv.first)] = 0;
+	}
+	(*fout) << "======================\n\n";
+	return true;
+}
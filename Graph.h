@@ -13,14 +13,77 @@
 #include <deque>
 #include <queue>
 #include <stack>
+#include <stdint.h>
 
 using namespace std;
 
+// Weighted edge u->v (LOAD buffer, edge lists in algorithms)
+struct Edge { int u, v, w; };
+
+// one adjacency entry (POD, flat arrays)
+struct AdjEntry { int to; int w; };
+
+// Row selection of PRINT / FLOYD: ascending original ids, nullptr = every row
+inline size_t rowCount(const std::vector<int>* rows, int n) { return rows ? rows->size() : (size_t)n; }
+inline int rowAt(const std::vector<int>* rows, size_t k) { return rows ? (*rows)[k] : (int)k; }
+
 // Base graph  (adjacency retrieval/insert/print).
 class Graph{	
 protected:
 	bool m_Type;   // true: adjacency list, false: adjacency matrix
 	int m_Size;    // vertices number
+	char m_Format; // input file format, 'L' or 'M'; PRINT reproduces it
+
+	// Edge summary, kept up to date by insertEdge (no scan needed)
+	int m_EdgeCount;    // directed edges stored
+	int m_SelfLoops;    // edges u->u
+	int m_NegEdges;     // directed edges with weight < 0
+	int m_MinWeight;    // lower bound of stored weights (never raised on overwrite)
+	int m_MaxWeight;    // upper bound of stored weights (never lowered on overwrite)
+
+	// Generation stamps: m_Gen changes on any insert, m_TopoGen only when the edge set changes
+	unsigned m_Gen;
+	unsigned m_TopoGen;
+
+	// Connected components of the undirected view, computed on demand
+	std::vector<int> m_Comp;   // m_Comp[v] = component label
+	int m_CompCount;
+	unsigned m_CompGen;        // m_TopoGen the labels were built for
+
+	// called by derived insertEdge around the actual store
+	void noteInsert(int from, int to, int weight);
+	void noteRemove(int from, int to, int weight);
+	void noteReweight(int oldWeight, int weight);
+
+	void buildComponents();
+
+	// Strongly connected components of the direct view (Tarjan), computed on demand.
+	// Ids follow Tarjan's completion order, so an edge between two components
+	// always runs from the larger id to the smaller one.
+	std::vector<int> m_Scc;        // m_Scc[v] = component id
+	int m_SccCount;
+	unsigned m_SccGen;             // m_TopoGen the ids were built for
+	// row c = bitset of the components c reaches; empty when over REACH_MAX_BYTES
+	std::vector<uint64_t> m_Reach;
+	size_t m_ReachWords;
+
+	void buildScc();
+
+	// Undirected view as CSR (row u ascending original id, min weight of both
+	// directions), built on demand for backends without incoming rows
+	std::vector<int> m_SymOff;
+	std::vector<AdjEntry> m_SymAdj;
+	unsigned m_SymGen;         // m_Gen the view was built for
+	void buildSymmetric();
+
+	// generic PRINT bodies through getOutEdges (any backend, any format)
+	bool printListForm(ofstream *fout, const std::vector<int>* rows);
+	bool printMatrixForm(ofstream *fout, const std::vector<int>* rows);
+
+	// Optional relabeling from LOAD (empty = identity)
+	// adjacency, insertEdge and getAdjacentEdges* use internal ids
+	std::vector<int> m_ToOrig;      // internal -> original
+	std::vector<int> m_ToInternal;  // original -> internal
 
 public:
 	Graph(bool type, int size);
@@ -29,18 +92,70 @@ public:
 	// Accessors
 	bool getType();	
 	int getSize();
+	char getFormat();
+	void setFormat(char format);
+
+	// Summary accessors, O(1)
+	int getEdgeCount();
+	int getSelfLoopCount();
+	int getNegEdgeCount();   // same answer for both views: undirected weight is min of both directions
+	int getMinWeight();
+	int getMaxWeight();
+	unsigned getGeneration();
+
+	// Undirected connectivity, O(1) after the first call until the edge set changes
+	bool isConnected();
+	int getComponentCount();
+	int getComponent(int vertex);
+
+	// Strong connectivity of the direct view, same caching as the components
+	int getSccCount();
+	int getScc(int vertex);
+	// component a reaches component b in the direct view (true when the index can't tell)
+	bool sccReaches(int a, int b) {
+		if(m_SccGen != m_TopoGen) buildScc();
+		if(a < b) return false;   // edges only lead to smaller ids
+		if(a == b || m_Reach.empty()) return true;
+		return (m_Reach[(size_t)a * m_ReachWords + b / 64] >> (b % 64)) & 1;
+	}
+	// Bytes the first SCC query will still allocate (0 once the index exists)
+	size_t getPendingSccBytes();
+
+	// Relabeling: set once before any insertEdge
+	void setOrder(const std::vector<int>& toInternal);
+	bool isRelabeled() { return !m_ToOrig.empty(); }
+	int toOrig(int v) { return m_ToOrig.empty() ? v : m_ToOrig[v]; }
+	int toInternal(int v) { return m_ToInternal.empty() ? v : m_ToInternal[v]; }
+
+	// Undirected neighbors of u from the cached CSR: f(v, w)
+	template<class F> void forEachSym(int u, F f) {
+		if(m_SymGen != m_Gen) buildSymmetric();
+		for(int i = m_SymOff[u]; i < m_SymOff[u + 1]; ++i) f(m_SymAdj[i].to, m_SymAdj[i].w);
+	}
 
 	// Adjacency providers
 	// getAdjacentEdges: undirect view (out + in)
 	// getAdjacentEdgesDirect: direct view (out only)
 	virtual void getAdjacentEdges(int vertex, map<int, int>* m) = 0;		
 	virtual void getAdjacentEdgesDirect(int vertex, map<int, int>* m) = 0;	
+	// getOutEdges: direct view as a flat (neighbor, weight) list, ascending original id
+	virtual void getOutEdges(int vertex, std::vector<std::pair<int, int>>* out);
 
 	// Insert weighted edge u->v with weight
 	virtual void insertEdge(int from, int to, int weight) = 0;				
+	// weight of edge u->v into *weight; false if there is none
+	virtual bool getEdge(int from, int to, int* weight);
+	// true when insertEdge is ignored (edges fixed at LOAD)
+	virtual bool isReadOnly();
+
+	// Bytes held by the representation (adjacency + bookkeeping)
+	virtual size_t getMemoryBytes();
+	// Bytes the first undirected query will still allocate (0 once the view exists)
+	virtual size_t getPendingUndirectedBytes();
 
-	// Print the graph to fout in required format
-	virtual	bool printGraph(ofstream *fout) = 0;
+	// Print the graph to fout in required format (the one of the input file),
+	// only the selected rows (the matrix header keeps every column)
+	virtual	bool printGraph(ofstream *fout, const std::vector<int>* rows = nullptr);
 };
 
-#endif
\ No newline at end of file
+#endif
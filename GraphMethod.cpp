@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include "GraphMethod.h"
+#include "Stats.h"
 #include <stack>
 #include <queue>
 #include <map>
@@ -9,161 +10,203 @@
 #include <utility>
 #include <limits>
 #include <algorithm>
+#include <string>
 
 using std::cout;
 using std::endl;
 
 // ---------- Utilities ----------
-static void viewNeighbors(Graph* g, char option, int u, std::map<int,int>& adj) {
-	if(option == 'O') g->getAdjacentEdgesDirect(u, &adj);
-	else g->getAdjacentEdges(u, &adj);
-}
+// Vertex ids inside the algorithms are internal (see Graph::setOrder);
+// everything printed or taken from the command goes through toOrig/toInternal.
+
+// Neighbor iteration of one view, resolved at compile time (no virtual call, no map):
+// Nbr<G, true> = direct view (out only), Nbr<G, false> = undirect view (out + in)
+template<class G, bool Directed> struct Nbr;
+template<class G> struct Nbr<G, true> {
+	template<class F> static void each(G& g, int u, F f) { g.forEachOut(u, f); }
+};
+template<class G> struct Nbr<G, false> {
+	template<class F> static void each(G& g, int u, F f) { g.forEachUndir(u, f); }
+};
 
-static bool has_neg_edge(Graph* g, char option) {
-	int n = g->getSize();
-	std::map<int,int> m;
-	for(int u=0; u<n; ++u) {
-		viewNeighbors(g, option, u, m);
-		for(auto& kv : m) if(kv.second < 0) return true;
-	}
-	return false;
+// Reachability classes of a view, from the graph's cached indexes:
+// direct view = strongly connected components, undirect view = connected components.
+// A vertex of class b is reachable from one of class a only if reaches(a, b).
+template<bool Directed> struct Reach;
+template<> struct Reach<true> {
+	static int count(Graph& g) { return g.getSccCount(); }
+	static int of(Graph& g, int v) { return g.getScc(v); }
+	static bool reaches(Graph& g, int a, int b) { return g.sccReaches(a, b); }
+};
+template<> struct Reach<false> {
+	static int count(Graph& g) { return g.getComponentCount(); }
+	static int of(Graph& g, int v) { return g.getComponent(v); }
+	static bool reaches(Graph&, int a, int b) { return a == b; }
+};
+
+// buffer bytes of a vector (for noteWorkBytes)
+template<class T> static size_t bytesOf(const std::vector<T>& v) { return v.capacity() * sizeof(T); }
+
+// min-heap whose buffer can be reported
+template<class T> struct MinHeap : std::priority_queue<T, std::vector<T>, std::greater<T> > {
+	size_t bytes() const { return this->c.capacity() * sizeof(T); }
+};
+
+// summary is maintained by insertEdge, no scan here
+// (undirected weight = min of both directions, so the views agree)
+static bool has_neg_edge(Graph& g) {
+	return g.getNegEdgeCount() > 0;
 }
 
-static bool is_connected_undir(Graph* g) {
-	int n = g->getSize();
-	if(n == 0) return false;
-	std::vector<int> visited(n, 0);
-	std::queue<int> q;
-	q.push(0); visited[0] = 1;
-	std::map<int,int> m;
-	while(!q.empty()) {
-		int u = q.front(); q.pop();
-		g->getAdjacentEdges(u, &m); // undirected view
-		for(auto& kv : m) if(!visited[kv.first]) {
-			visited[kv.first] = 1;
-			q.push(kv.first);
-		}
-	}
-	for(int i=0;i<n;++i) if(!visited[i]) return false;
-	return true;
+// component labels are cached by the graph until the edge set changes
+static bool is_connected_undir(Graph& g) {
+	return g.isConnected();
 }
 
 // ---------- BFS ----------
-bool BFS(Graph* graph, char option, int vertex)
+template<class G, bool Directed>
+bool BFS(G& graph, int vertex)
 {
-	int n = graph->getSize();
-	std::vector<int> visited(n, 0);
-	std::queue<int> q;
-	std::vector<int> order;
+	int n = graph.getSize();
+	std::vector<char> visited(n, 0);
+	std::vector<int> order;   // doubles as the queue
 
 	cout << "========BFS========\n";
-	cout << (option=='O' ? "Directed Graph BFS" : "Undirected Graph BFS") << "\n";
+	cout << (Directed ? "Directed Graph BFS" : "Undirected Graph BFS") << "\n";
 	cout << "Start: " << vertex << "\n";
 
-	visited[vertex] = 1;
-	q.push(vertex);
-	while(!q.empty()){
-		int u = q.front(); q.pop();
-		order.push_back(u);
-		std::map<int,int> adj;
-		viewNeighbors(graph, option, u, adj);
-		for(const auto& kv : adj){ // map keeps ascending order
-			int v = kv.first;
+	int s = graph.toInternal(vertex);
+	visited[s] = 1;
+	order.push_back(s);
+	for(size_t head = 0; head < order.size(); ++head){
+		int u = order[head];
+		STAT_INC(settled);
+		Nbr<G, Directed>::each(graph, u, [&](int v, int){ // ascending original id
+			STAT_INC(scanned);
 			if(!visited[v]) {
 				visited[v] = 1;
-				q.push(v);
+				order.push_back(v);
 			}
-		}
+		});
 	}
 
+	noteWorkBytes(bytesOf(visited) + bytesOf(order));
+
 	// print order
+	PhaseTimer fmt(&g_Phases.formatMs);
 	for(size_t i=0;i<order.size();++i){
 		if(i) cout << " -> ";
-		cout << order[i];
+		cout << graph.toOrig(order[i]);
 	}
 	cout << "\n======================\n\n";
 	return true;
 }
 
 // ---------- DFS ----------
-static void dfsRec(Graph* g, char option, int u, std::vector<int>& visited, std::vector<int>& order) {
-	visited[u]=1;
-	order.push_back(u);
-	std::map<int,int> adj;
-	viewNeighbors(g, option, u, adj);
-	for(const auto& kv: adj) {
-		int v = kv.first;
-		if(!visited[v]) dfsRec(g, option, v, visited, order);
-	}
-}
-
-bool DFS(Graph* graph, char option, int vertex)
+// Iterative: neighbors pushed in reverse, visited checked on pop, which gives the
+// same preorder as the recursive version without its stack depth limit.
+template<class G, bool Directed>
+bool DFS(G& graph, int vertex)
 {
-	int n = graph->getSize();
-	std::vector<int> visited(n, 0);
+	int n = graph.getSize();
+	std::vector<char> visited(n, 0);
 	std::vector<int> order;
 	cout << "========DFS========\n";
-	cout << (option=='O' ? "Directed Graph DFS" : "Undirected Graph DFS") << "\n";
+	cout << (Directed ? "Directed Graph DFS" : "Undirected Graph DFS") << "\n";
 	cout << "Start: " << vertex << "\n";
 
-	dfsRec(graph, option, vertex, visited, order);
+	std::vector<int> stk(1, graph.toInternal(vertex));
+	std::vector<int> next;
+	while(!stk.empty()){
+		int u = stk.back(); stk.pop_back();
+		if(visited[u]) continue;
+		visited[u] = 1;
+		order.push_back(u);
+		STAT_INC(settled);
+		next.clear();
+		Nbr<G, Directed>::each(graph, u, [&](int v, int){
+			STAT_INC(scanned);
+			if(!visited[v]) next.push_back(v);
+		});
+		stk.insert(stk.end(), next.rbegin(), next.rend());
+	}
+	noteWorkBytes(bytesOf(visited) + bytesOf(order) + bytesOf(stk) + bytesOf(next));
 
+	PhaseTimer fmt(&g_Phases.formatMs);
 	for(size_t i=0;i<order.size();++i){
 		if(i) cout << " -> ";
-		cout << order[i];
+		cout << graph.toOrig(order[i]);
 	}
 	cout << "\n======================\n\n";
 	return true;
 }
 
 // ---------- Kruskal (Undirected, Weighted) ----------
-struct Edge { int u,v,w; };
 struct Dsu {
 	std::vector<int> p, r;
 	explicit Dsu(int n): p(n), r(n,0){ for(int i=0;i<n;++i) p[i]=i; }
-	int f(int x){ return p[x]==x?x:p[x]=f(p[x]); }
+	int f(int x){ while(p[x]!=x){ p[x]=p[p[x]]; x=p[x]; } return x; }
 	bool unite(int a,int b){ a=f(a); b=f(b); if(a==b) return false; if(r[a]<r[b]) std::swap(a,b); p[b]=a; if(r[a]==r[b]) r[a]++; return true; }
 };
 
-bool Kruskal(Graph* graph)
+// Kruskal order: weight, then endpoints. DynamicMST keeps the same (w, a, b)
+// order, so a maintained tree prints exactly what a fresh KRUSKAL would
+static bool byWeightEnds(const Edge& a, const Edge& b)
 {
-	int n = graph->getSize();
+	if(a.w != b.w) return a.w < b.w;
+	if(a.u != b.u) return a.u < b.u;
+	return a.v < b.v;
+}
+
+template<class G>
+bool Kruskal(G& graph, DynamicMST& keep)
+{
+	int n = graph.getSize();
 	// connectivity check
 	if(!is_connected_undir(graph)) {
+		keep.clear();
 		cout << "========ERROR========\n";
         cout << "500\n";
         cout << "======================\n\n";
 		return false;
 	}
 
-	// build undirected unique edge set (u<v)
+	// build undirected unique edge set (a<=b) in original ids;
+	// the undirected view is symmetric, so each pair is taken from its smaller end
 	std::vector<Edge> edges;
-	std::set<std::pair<int,int>> seen;
-	for(int u=0; u<n; ++u) {
-		std::map<int,int> adj;
-		graph->getAdjacentEdges(u, &adj); // undirected view
-		for(const auto& kv : adj){
-			int v = kv.first, w = kv.second;
-			int a = std::min(u,v), b = std::max(u,v);
-			if(seen.insert({a,b}).second){
-				edges.push_back({a,b,w});
-			}
-		}
+	for(int a=0; a<n; ++a) {
+		Nbr<G, false>::each(graph, graph.toInternal(a), [&](int v, int w){
+			STAT_INC(scanned);
+			int b = graph.toOrig(v);
+			if(a <= b) edges.push_back({a,b,w});
+		});
 	}
 
-	std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b){ return a.w < b.w; });
+	std::sort(edges.begin(), edges.end(), byWeightEnds);
 
 	Dsu dsu(n);
-	std::vector<std::vector<std::pair<int,int>>> mst(n);
-	long long total = 0;
+	std::vector<Edge> tree;
 	for(const auto& e: edges){
 		if(dsu.unite(e.u, e.v)){
-			mst[e.u].push_back({e.v, e.w});
-			mst[e.v].push_back({e.u, e.w});
-			total += e.w;
+			STAT_INC(relaxed);
+			tree.push_back(e);
 		}
 	}
+	keep.build(n, tree, graph.getGeneration());
+	noteWorkBytes(bytesOf(edges) + bytesOf(dsu.p) + bytesOf(dsu.r) + bytesOf(tree) + keep.getMemoryBytes());
+	return printKruskal(keep);
+}
+
+bool printKruskal(DynamicMST& t)
+{
+	int n = t.getSize();
+	std::vector<std::vector<std::pair<int,int>>> mst(n);
+	for(const auto& e : t.getEdges()){
+		mst[e.u].push_back({e.v, e.w});
+		mst[e.v].push_back({e.u, e.w});
+	}
 
+	PhaseTimer fmt(&g_Phases.formatMs);
 	cout << "========KRUSKAL========\n";
 	// print adjacency list of MST (neighbors sorted by vertex id)
 	for(int i=0;i<n;++i){
@@ -176,107 +219,157 @@ bool Kruskal(Graph* graph)
 		}
 		cout << "\n";
 	}
-	cout << "Cost: " << total << "\n";
+	cout << "Cost: " << t.getCost() << "\n";
 	cout << "======================\n\n";
 	return true;
 }
 
 // ---------- Dijkstra ----------
-bool Dijkstra(Graph* graph, char option, int start)
+template<class G, bool Directed, class D>
+bool Dijkstra(G& graph, int start, bool predOnly)
 {
-	if(has_neg_edge(graph, option)) {
+	if(has_neg_edge(graph)) {
 		cout << "========ERROR========\n600\n======================\n\n";
 		return false;
 	}
 
-	int n = graph->getSize();
-	const long long INF = std::numeric_limits<long long>::max()/4;
-	std::vector<long long> dist(n, INF);
+	int n = graph.getSize();
+	const D INF = std::numeric_limits<D>::max()/4;
+	std::vector<D> dist(n, INF);
 	std::vector<int> parent(n, -1);
-	using P = std::pair<long long,int>;
-	std::priority_queue<P, std::vector<P>, std::greater<P> > pq;
+	typedef std::pair<D,int> P;
+	MinHeap<P> pq;
 
-	dist[start]=0;
-	pq.push(P(0, start));  
+	// arrays use internal ids, the heap key uses original ids so ties pop in the same order
+	int s = graph.toInternal(start);
+	dist[s]=0;
+	pq.push(P(0, start));
+	STAT_INC(heapPush);
 
 	while(!pq.empty()){
-		P cur = pq.top();   
-		pq.pop();           
-		long long d = cur.first; 
-		int u = cur.second;      
+		P cur = pq.top();
+		pq.pop();
+		STAT_INC(heapPop);
+		D d = cur.first;
+		int u = graph.toInternal(cur.second);
 
 		if(d!=dist[u]) continue;
-		std::map<int,int> adj;
-		viewNeighbors(graph, option, u, adj);
-		for(const auto& kv: adj){
-			int v = kv.first; int w = kv.second;
-			if(dist[v] > dist[u] + w){
-				dist[v] = dist[u] + w;
+		STAT_INC(settled);
+		Nbr<G, Directed>::each(graph, u, [&](int v, int w){
+			STAT_INC(scanned);
+			D nd = d + w;
+			if(dist[v] > nd){
+				dist[v] = nd;
 				parent[v] = u;
-				pq.push(P(dist[v], v)); 
+				pq.push(P(nd, graph.toOrig(v)));
+				STAT_INC(relaxed);
+				STAT_INC(heapPush);
 			}
-		}
+		});
 	}
+	noteWorkBytes(bytesOf(dist) + bytesOf(parent) + pq.bytes());
 
+	PhaseTimer fmt(&g_Phases.formatMs);
 	cout << "========DIJKSTRA========\n";
-	cout << (option=='O' ? "Directed Graph Dijkstra" : "Undirected Graph Dijkstra") << "\n";
+	cout << (Directed ? "Directed Graph Dijkstra" : "Undirected Graph Dijkstra") << "\n";
 	cout << "Start: " << start << "\n";
 
-	for(int v=0; v<n; ++v){
-		cout << "[" << v << "] ";
+	// compact mode: one predecessor per vertex, O(n) output
+	if(predOnly){
+		for(int o=0; o<n; ++o){
+			int v = graph.toInternal(o);
+			cout << "[" << o << "] ";
+			if(dist[v] == INF) cout << "x\n";
+			else if(parent[v] == -1) cout << "- (" << dist[v] << ")\n";
+			else cout << graph.toOrig(parent[v]) << " (" << dist[v] << ")\n";
+		}
+		cout << "======================\n\n";
+		return true;
+	}
+
+	// path lines: parent walk into one reused stack, popped in root-to-node order
+	// (no per-vertex vector, no reverse), each line built in one reused buffer
+	std::vector<int> stk;
+	std::string line;
+	for(int o=0; o<n; ++o){
+		int v = graph.toInternal(o);
+		line = "[" + std::to_string(o) + "] ";
 		if(dist[v] == INF){
-			cout << "x\n";
+			line += "x\n";
+			cout << line;
 			continue;
 		}
-		// reconstruct path
-		std::vector<int> path;
-		for(int x=v; x!=-1; x=parent[x]) path.push_back(x);
-		std::reverse(path.begin(), path.end());
-		for(size_t i=0;i<path.size();++i){
-			if(i) cout << " -> ";
-			cout << path[i];
+		stk.clear();
+		for(int x=v; x!=-1; x=parent[x]) stk.push_back(graph.toOrig(x));
+		line += std::to_string(stk.back());
+		for(size_t i=stk.size()-1; i-- > 0; ){
+			line += " -> ";
+			line += std::to_string(stk[i]);
 		}
-		cout << " (" << dist[v] << ")\n";
+		line += " (" + std::to_string(dist[v]) + ")\n";
+		cout << line;
 	}
 	cout << "======================\n\n";
 	return true;
 }
 
 // ---------- Bellman-Ford ----------
-bool Bellmanford(Graph* graph, char option, int s_vertex, int e_vertex) 
+template<class G, bool Directed, class D>
+bool Bellmanford(G& graph, int s_vertex, int e_vertex)
 {
-	int n = graph->getSize();
-	struct E { int u,v,w; };
-	std::vector<E> edges;
-
-	// Build edge list by option
+	int n = graph.getSize();
+	std::vector<Edge> edges;
+	int s = graph.toInternal(s_vertex);
+	int t = graph.toInternal(e_vertex);
+
+	// Build edge list by view, in original id order so relaxation ties match.
+	// Only tails reachable from s can ever relax; a negative cycle needs a
+	// negative edge inside one class, otherwise the final check is skipped.
+	int cs = Reach<Directed>::of(graph, s);
+	bool check = false;
+	// count first so the list is allocated once, at its exact size
+	size_t count = 0;
 	for(int u=0; u<n; ++u){
-		std::map<int,int> adj;
-		viewNeighbors(graph, option, u, adj);
-		for(const auto& kv: adj){
-			edges.push_back({u, kv.first, kv.second});
-		}
+		if(Reach<Directed>::reaches(graph, cs, Reach<Directed>::of(graph, u)))
+			Nbr<G, Directed>::each(graph, u, [&count](int, int){ count++; });
+	}
+	edges.reserve(count);
+	for(int o=0; o<n; ++o){
+		int u = graph.toInternal(o);
+		int cu = Reach<Directed>::of(graph, u);
+		if(!Reach<Directed>::reaches(graph, cs, cu)) continue;
+		Nbr<G, Directed>::each(graph, u, [&](int v, int w){
+			edges.push_back({u, v, w});
+			if(w < 0 && Reach<Directed>::of(graph, v) == cu) check = true;
+		});
 	}
+	STAT_ADD(scanned, edges.size());
 
-	const long long INF = std::numeric_limits<long long>::max()/4;
-	std::vector<long long> dist(n, INF);
+	const D INF = std::numeric_limits<D>::max()/4;
+	std::vector<D> dist(n, INF);
 	std::vector<int> parent(n, -1);
-	dist[s_vertex] = 0;
+	dist[s] = 0;
 
-	for(int i=0;i<n-1;++i){
+	// t out of reach and no cycle to report: nothing to relax
+	bool needed = check || Reach<Directed>::reaches(graph, cs, Reach<Directed>::of(graph, t));
+	for(int i=0;needed && i<n-1;++i){
 		bool any=false;
+		STAT_ADD(scanned, edges.size());
 		for(const auto& e: edges){
 			if(dist[e.u] == INF) continue;
 			if(dist[e.v] > dist[e.u] + e.w){
 				dist[e.v] = dist[e.u] + e.w;
 				parent[e.v] = e.u;
+				STAT_INC(relaxed);
 				any=true;
 			}
 		}
 		if(!any) break;
 	}
+	noteWorkBytes(bytesOf(edges) + bytesOf(dist) + bytesOf(parent));
 	// detect negative cycle
-	for(const auto& e: edges){
+	for(size_t i=0; check && i<edges.size(); ++i){
+		const Edge& e = edges[i];
 		if(dist[e.u]!=INF && dist[e.v] > dist[e.u] + e.w){
 			cout << "========ERROR========\n";
             cout << "700\n";
@@ -285,8 +378,150 @@ bool Bellmanford(Graph* graph, char option, int s_vertex, int e_vertex)
 		}
 	}
 
+	PhaseTimer fmt(&g_Phases.formatMs);
 	cout << "========BELLMANFORD========\n";
-	cout << (option=='O' ? "Directed Graph Bellman-Ford" : "Undirected Graph Bellman-Ford") << "\n";
+	cout << (Directed ? "Directed Graph Bellman-Ford" : "Undirected Graph Bellman-Ford") << "\n";
+
+	if(dist[t] == INF){
+		cout << "x\n";
+		cout << "Cost: x\n";
+		cout << "======================\n\n";
+		return true;
+	}
+
+	std::vector<int> path;
+	for(int x=t; x!=-1; x=parent[x]) path.push_back(graph.toOrig(x));
+	std::reverse(path.begin(), path.end());
+	for(size_t i=0;i<path.size();++i){
+		if(i) cout << " -> ";
+		cout << path[i];
+	}
+	cout << "\nCost: " << dist[t] << "\n";
+	cout << "======================\n\n";
+	return true;
+}
+
+// ---------- Out-of-core variants (ExternalGraph) ----------
+// Same output as the in-memory versions: the edge files are sorted by (u, v),
+// which is exactly the order the in-memory views produce.
+
+// whole-view sequential pass, resolved at compile time like Nbr
+template<bool Directed> struct EdgeScan;
+template<> struct EdgeScan<true> {
+	template<class F> static void each(ExternalGraph& g, F f) { g.scanOut(f); }
+};
+template<> struct EdgeScan<false> {
+	template<class F> static void each(ExternalGraph& g, F f) { g.scanUndir(f); }
+};
+
+template<bool Directed>
+bool ExternalBFS(ExternalGraph& graph, int vertex)
+{
+	int n = graph.getSize();
+	std::vector<bool> visited(n, false);   // one bit per vertex
+	std::vector<int> order;                // doubles as the queue
+
+	cout << "========BFS========\n";
+	cout << (Directed ? "Directed Graph BFS" : "Undirected Graph BFS") << "\n";
+	cout << "Start: " << vertex << "\n";
+
+	visited[vertex] = true;
+	order.push_back(vertex);
+	for(size_t head = 0; head < order.size(); ++head){
+		STAT_INC(settled);
+		// one seek, then a sequential read of the row
+		Nbr<ExternalGraph, Directed>::each(graph, order[head], [&](int v, int){
+			STAT_INC(scanned);
+			if(!visited[v]) {
+				visited[v] = true;
+				order.push_back(v);
+			}
+		});
+	}
+	noteWorkBytes(visited.capacity() / 8 + bytesOf(order));
+
+	PhaseTimer fmt(&g_Phases.formatMs);
+	for(size_t i=0;i<order.size();++i){
+		if(i) cout << " -> ";
+		cout << order[i];
+	}
+	cout << "\n======================\n\n";
+	return true;
+}
+
+bool ExternalKruskal(ExternalGraph& graph, DynamicMST& keep)
+{
+	int n = graph.getSize();
+
+	// undirected pairs (a<=b) of the symmetric file, external sort by weight
+	EdgeSorter sorter(byWeightEnds, graph.getBudget());
+	graph.scanUndir([&sorter](const Edge& e){
+		STAT_INC(scanned);
+		if(e.u <= e.v) sorter.push(e);
+	});
+
+	Dsu dsu(n);
+	std::vector<Edge> tree;
+	bool ok = sorter.finish([&](const Edge& e){
+		if((int)tree.size() == n-1) return;   // tree complete, drain the rest
+		if(dsu.unite(e.u, e.v)){
+			STAT_INC(relaxed);
+			tree.push_back(e);
+		}
+	});
+	noteWorkBytes(graph.getBudget() + bytesOf(dsu.p) + bytesOf(dsu.r) + bytesOf(tree) + keep.getMemoryBytes());
+	// fewer than n-1 tree edges: not connected (the in-memory version checks first)
+	if(!ok || (int)tree.size() != n-1) {
+		keep.clear();
+		cout << "========ERROR========\n";
+		cout << "500\n";
+		cout << "======================\n\n";
+		return false;
+	}
+	keep.build(n, tree, graph.getGeneration());
+	return printKruskal(keep);
+}
+
+template<bool Directed, class D>
+bool ExternalBellmanford(ExternalGraph& graph, int s_vertex, int e_vertex)
+{
+	int n = graph.getSize();
+	const D INF = std::numeric_limits<D>::max()/4;
+	std::vector<D> dist(n, INF);
+	std::vector<int> parent(n, -1);
+	dist[s_vertex] = 0;
+
+	// each round is one sequential pass over the edge file
+	for(int i=0;i<n-1;++i){
+		bool any=false;
+		EdgeScan<Directed>::each(graph, [&](const Edge& e){
+			STAT_INC(scanned);
+			if(dist[e.u] == INF) return;
+			if(dist[e.v] > dist[e.u] + e.w){
+				dist[e.v] = dist[e.u] + e.w;
+				parent[e.v] = e.u;
+				STAT_INC(relaxed);
+				any=true;
+			}
+		});
+		if(!any) break;
+	}
+	noteWorkBytes(bytesOf(dist) + bytesOf(parent));
+	// detect negative cycle (one more pass)
+	bool neg = false;
+	EdgeScan<Directed>::each(graph, [&](const Edge& e){
+		if(dist[e.u]!=INF && dist[e.v] > dist[e.u] + e.w) neg = true;
+	});
+	if(neg){
+		cout << "========ERROR========\n";
+		cout << "700\n";
+		cout << "======================\n\n";
+		return false;
+	}
+
+	PhaseTimer fmt(&g_Phases.formatMs);
+	cout << "========BELLMANFORD========\n";
+	cout << (Directed ? "Directed Graph Bellman-Ford" : "Undirected Graph Bellman-Ford") << "\n";
 
 	if(dist[e_vertex] == INF){
 		cout << "x\n";
@@ -307,113 +542,376 @@ bool Bellmanford(Graph* graph, char option, int s_vertex, int e_vertex)
 	return true;
 }
 
-// ---------- Floyd-Warshall ----------
-bool FLOYD(Graph* graph, char option)
+// ---------- all-pairs core (shared by FLOYD and CENTRALITY) ----------
+// d is n*n row-major; false if a negative cycle shows up on the diagonal
+template<class G, bool Directed, class D>
+static bool allPairs(G& graph, std::vector<D>& d)
 {
-	int n = graph->getSize();
-	const long long INF = std::numeric_limits<long long>::max()/4;
-	std::vector<std::vector<long long>> d(n, std::vector<long long>(n, INF));
-	for(int i=0;i<n;++i) d[i][i]=0;
+	int n = graph.getSize();
+	const D INF = std::numeric_limits<D>::max()/4;
+	d.assign((size_t)n * n, INF);
+	for(int i=0;i<n;++i) d[(size_t)i*n+i]=0;
 
 	for(int u=0; u<n; ++u){
-		std::map<int,int> adj;
-		viewNeighbors(graph, option, u, adj);
-		for(const auto& kv: adj) d[u][kv.first] = std::min<long long>(d[u][kv.first], kv.second);
+		D* row = &d[(size_t)u*n];
+		Nbr<G, Directed>::each(graph, u, [&](int v, int w){
+			if(w < row[v]) row[v] = w;
+		});
 	}
 
-	// Floyd
+	// Floyd; cell (i, j) can only be finite if class(i) reaches class(j), so
+	// round k only visits rows that reach k and columns k reaches
+	int classes = Reach<Directed>::count(graph);
+	std::vector<int> cls, rows, cols;
+	if(classes > 1){
+		cls.resize(n);
+		for(int v=0; v<n; ++v) cls[v] = Reach<Directed>::of(graph, v);
+	}
 	for(int k=0;k<n;++k){
-		for(int i=0;i<n;++i){
-			if(d[i][k]==INF) continue;
-			for(int j=0;j<n;++j){
-				if(d[k][j]==INF) continue;
-				if(d[i][j] > d[i][k] + d[k][j]) d[i][j] = d[i][k] + d[k][j];
+		const D* dk = &d[(size_t)k*n];
+		if(classes == 1){
+			for(int i=0;i<n;++i){
+				D* di = &d[(size_t)i*n];
+				D dik = di[k];
+				if(dik==INF) continue;
+				STAT_ADD(scanned, n);
+				for(int j=0;j<n;++j){
+					if(dk[j]==INF) continue;
+					if(di[j] > dik + dk[j]) { di[j] = dik + dk[j]; STAT_INC(relaxed); }
+				}
+			}
+			continue;
+		}
+		rows.clear();
+		cols.clear();
+		for(int v=0; v<n; ++v){
+			if(Reach<Directed>::reaches(graph, cls[v], cls[k])) rows.push_back(v);
+			if(Reach<Directed>::reaches(graph, cls[k], cls[v])) cols.push_back(v);
+		}
+		for(int i : rows){
+			D* di = &d[(size_t)i*n];
+			D dik = di[k];
+			if(dik==INF) continue;
+			STAT_ADD(scanned, cols.size());
+			for(int j : cols){
+				if(dk[j]==INF) continue;
+				if(di[j] > dik + dk[j]) { di[j] = dik + dk[j]; STAT_INC(relaxed); }
 			}
 		}
 	}
 
+	noteWorkBytes(bytesOf(d) + bytesOf(cls) + bytesOf(rows) + bytesOf(cols));
+
 	// negative cycle?
-	for(int i=0;i<n;++i){
-		if(d[i][i] < 0){
-			cout << "========ERROR========\n";
-            cout << "800\n";
-            cout << "======================\n\n";
-			return false;
-		}
-	}
+	for(int i=0;i<n;++i) if(d[(size_t)i*n+i] < 0) return false;
+	return true;
+}
 
+// ---------- Floyd-Warshall ----------
+static void printFloydHeader(int n, bool directed)
+{
 	cout << "========FLOYD========\n";
-	cout << (option=='O' ? "Directed Graph Floyd" : "Undirected Graph Floyd") << "\n";
-	// header
+	cout << (directed ? "Directed Graph Floyd" : "Undirected Graph Floyd") << "\n";
 	cout << "    ";
 	for(int j=0;j<n;++j) cout << "[" << j << "] ";
 	cout << "\n";
-	// rows
-	for(int i=0;i<n;++i){
-		cout << "[" << i << "] ";
-		for(int j=0;j<n;++j){
-			if(d[i][j]==INF) cout << "x";
-			else cout << d[i][j];
-			if(j+1<n) cout << "  ";
-		}
-		cout << "\n";
+}
+
+// row of original vertex oi; row[] indexed by internal id
+template<class D>
+static void printFloydRow(Graph& graph, int oi, const D* row, D INF)
+{
+	int n = graph.getSize();
+	cout << "[" << oi << "] ";
+	for(int j=0;j<n;++j){
+		D x = row[graph.toInternal(j)];
+		if(x==INF) cout << "x";
+		else cout << x;
+		if(j+1<n) cout << "  ";
+	}
+	cout << "\n";
+}
+
+// the result is kept in 'keep' (64-bit, DIST_INF) and printed from there
+template<class G, bool Directed, class D>
+bool FLOYD(G& graph, DistMatrix& keep)
+{
+	int n = graph.getSize();
+	const D INF = std::numeric_limits<D>::max()/4;
+	std::vector<D> d;
+	keep.valid = true;
+	keep.gen = graph.getGeneration();
+	keep.negCycle = !allPairs<G, Directed, D>(graph, d);
+	keep.d.clear();
+	if(!keep.negCycle){
+		keep.d.resize((size_t)n * n);
+		for(size_t i = 0; i < d.size(); ++i) keep.d[i] = d[i] == INF ? DIST_INF : (long long)d[i];
+	}
+	noteWorkBytes(bytesOf(d) + bytesOf(keep.d));
+	return printFloyd(graph, Directed, keep);
+}
+
+bool printFloyd(Graph& graph, bool directed, const DistMatrix& m, const std::vector<int>* rows)
+{
+	if(m.negCycle){
+		cout << "========ERROR========\n";
+        cout << "800\n";
+        cout << "======================\n\n";
+		return false;
+	}
+
+	int n = graph.getSize();
+	PhaseTimer fmt(&g_Phases.formatMs);
+	printFloydHeader(n, directed);
+	// rows (original order)
+	for(size_t k=0;k<rowCount(rows, n);++k){
+		int oi = rowAt(rows, k);
+		printFloydRow(graph, oi, &m.d[(size_t)graph.toInternal(oi)*n], DIST_INF);
 	}
 	cout << "======================\n\n";
 	return true;
 }
 
-// ---------- Closeness Centrality (Undirected, Weighted) ----------
-bool Centrality(Graph* graph) {
-	int n = graph->getSize();
-	const long long INF = std::numeric_limits<long long>::max()/4;
-	// Reuse Floyd (undirected)
-	// Build distances
-	std::vector<std::vector<long long>> d(n, std::vector<long long>(n, INF));
-	for(int i=0;i<n;++i) d[i][i]=0;
-	for(int u=0; u<n; ++u){
-		std::map<int,int> adj;
-		graph->getAdjacentEdges(u, &adj); // undirected
-		for(const auto& kv: adj) d[u][kv.first] = std::min<long long>(d[u][kv.first], kv.second);
+// Edge u->v now weighs w (new, or lowered): a shortest path uses it at most once,
+// so d[i][j] = min(d[i][j], d[i][u] + w + d[v][j]) over the old row v / column u.
+// Undirected, the edge also runs v->u.
+void relaxEdge(DistMatrix& m, int n, int u, int v, int w, bool directed)
+{
+	if(!m.valid || m.negCycle) return;   // inserting never removes a negative cycle
+	long long* d = m.d.data();
+	// the new edge closes a negative cycle (undirected: u-v-u itself)
+	bool neg = directed ? (d[(size_t)v*n+u] != DIST_INF && d[(size_t)v*n+u] + w < 0) : w < 0;
+	if(neg){
+		m.negCycle = true;
+		std::vector<long long>().swap(m.d);
+		return;
 	}
-	for(int k=0;k<n;++k){
-		for(int i=0;i<n;++i){
-			if(d[i][k]==INF) continue;
+
+	std::vector<long long> toU(n), fromV((size_t)n), toV, fromU;
+	for(int i=0;i<n;++i) toU[i] = d[(size_t)i*n+u];
+	std::copy(d + (size_t)v*n, d + (size_t)v*n + n, fromV.begin());
+	if(!directed){
+		toV.resize(n);
+		fromU.assign(d + (size_t)u*n, d + (size_t)u*n + n);
+		for(int i=0;i<n;++i) toV[i] = d[(size_t)i*n+v];
+	}
+
+	for(int i=0;i<n;++i){
+		long long* di = d + (size_t)i*n;
+		// via u->v
+		if(toU[i] != DIST_INF){
+			long long a = toU[i] + w;
+			STAT_ADD(scanned, n);
 			for(int j=0;j<n;++j){
-				if(d[k][j]==INF) continue;
-				if(d[i][j] > d[i][k] + d[k][j]) d[i][j] = d[i][k] + d[k][j];
+				if(fromV[j] == DIST_INF) continue;
+				if(di[j] > a + fromV[j]) { di[j] = a + fromV[j]; STAT_INC(relaxed); }
 			}
 		}
-	}
-	for(int i=0;i<n;++i){
-		if(d[i][i] < 0){
-			cout << "========ERROR========\n";
-            cout << "900\n";
-            cout << "======================\n\n";
-			return false;
+		// via v->u
+		if(!directed && toV[i] != DIST_INF){
+			long long a = toV[i] + w;
+			STAT_ADD(scanned, n);
+			for(int j=0;j<n;++j){
+				if(fromU[j] == DIST_INF) continue;
+				if(di[j] > a + fromU[j]) { di[j] = a + fromU[j]; STAT_INC(relaxed); }
+			}
 		}
 	}
+}
 
-	// Compute closeness centrality as (n-1) / sum of distances to others
-	std::vector<long long> denom(n, 0);
-	for(int u=0; u<n; ++u){
-		long long sum=0;
-		for(int v=0; v<n; ++v){
-			if(u==v) continue;
-			if(d[u][v] == INF) sum += 0; // unreachable contributes 0; spec doesn't define, we keep as is.
-			else sum += d[u][v];
-		}
-		denom[u]=sum;
+// ---------- Closeness Centrality (Undirected, Weighted) ----------
+// sum of distances from u to every other vertex
+template<class D>
+static long long distanceSum(const D* row, int n, int u, D INF)
+{
+	long long sum=0;
+	for(int v=0; v<n; ++v){
+		if(u==v) continue;
+		if(row[v] == INF) sum += 0; // unreachable contributes 0; spec doesn't define, we keep as is.
+		else sum += row[v];
 	}
+	return sum;
+}
+
+// denom[] indexed by internal id
+static bool printCentrality(Graph& graph, const std::vector<long long>& denom)
+{
+	int n = graph.getSize();
 	// find minimum denominator (max centrality)
 	long long best = std::numeric_limits<long long>::max();
 	for(int i=0;i<n;++i) best = std::min(best, denom[i]);
 
+	PhaseTimer fmt(&g_Phases.formatMs);
 	cout << "========CENTRALITY========\n";
 	for(int i=0;i<n;++i){
-		cout << "[" << i << "] " << (n-1) << "/" << denom[i];
-		if(denom[i] == best) cout << " <- Most Central";
+		int u = graph.toInternal(i);
+		cout << "[" << i << "] " << (n-1) << "/" << denom[u];
+		if(denom[u] == best) cout << " <- Most Central";
 		cout << "\n";
 	}
 	cout << "======================\n\n";
 	return true;
-}
\ No newline at end of file
+}
+template<class G, class D>
+bool Centrality(G& graph) {
+	int n = graph.getSize();
+	const D INF = std::numeric_limits<D>::max()/4;
+	// Reuse Floyd (undirected)
+	std::vector<D> d;
+	if(!allPairs<G, false, D>(graph, d)){
+		cout << "========ERROR========\n";
+        cout << "900\n";
+        cout << "======================\n\n";
+		return false;
+	}
+
+	// Compute closeness centrality as (n-1) / sum of distances to others
+	// (sums stay 64-bit even when distances are 32-bit)
+	std::vector<long long> denom(n, 0);
+	for(int u=0; u<n; ++u) denom[u] = distanceSum(&d[(size_t)u*n], n, u, INF);
+	noteWorkBytes(bytesOf(d) + bytesOf(denom));
+	return printCentrality(graph, denom);
+}
+
+// ---------- per-source engine (FLOYD / CENTRALITY under a memory budget, FLOYD row subsets) ----------
+// Johnson: potentials h from Bellman-Ford out of a virtual source tied to every
+// vertex, then one Dijkstra per source on w + h[u] - h[v] >= 0.
+// O(n + m) memory instead of n^2, rows come out one at a time.
+
+// false if the view has a negative cycle (what allPairs sees on its diagonal)
+template<class G, bool Directed, class D>
+static bool potentials(G& graph, std::vector<D>& h)
+{
+	int n = graph.getSize();
+	h.assign(n, 0);    // virtual source: 0-edge to every vertex
+	if(graph.getNegEdgeCount() == 0) return true;
+	// n+1 vertices with the virtual one: settled after n rounds unless a cycle is negative
+	for(int i=0;i<=n;++i){
+		bool any=false;
+		for(int u=0;u<n;++u){
+			Nbr<G, Directed>::each(graph, u, [&](int v, int w){
+				STAT_INC(scanned);
+				if(h[u] + w < h[v]) { h[v] = h[u] + w; any=true; }
+			});
+		}
+		if(!any) return true;
+	}
+	return false;
+}
+
+// dist[] (internal ids) from internal source s, real distances
+template<class G, bool Directed, class D>
+static void sourceDistances(G& graph, int s, const std::vector<D>& h, std::vector<D>& dist)
+{
+	typedef std::pair<D,int> P;
+	const D INF = std::numeric_limits<D>::max()/4;
+	dist.assign(graph.getSize(), INF);
+	MinHeap<P> pq;
+	dist[s]=0;
+	pq.push(P(0, s));
+	STAT_INC(heapPush);
+	while(!pq.empty()){
+		P cur = pq.top();
+		pq.pop();
+		STAT_INC(heapPop);
+		int u = cur.second;
+		if(cur.first != dist[u]) continue;
+		STAT_INC(settled);
+		Nbr<G, Directed>::each(graph, u, [&](int v, int w){
+			STAT_INC(scanned);
+			D nd = cur.first + w + h[u] - h[v];
+			if(dist[v] > nd){ dist[v] = nd; pq.push(P(nd, v)); STAT_INC(relaxed); STAT_INC(heapPush); }
+		});
+	}
+	noteWorkBytes(bytesOf(h) + bytesOf(dist) + pq.bytes());
+	for(size_t v=0; v<dist.size(); ++v) if(dist[v] != INF) dist[v] += h[v] - h[s];
+}
+
+template<class G, bool Directed, class D>
+bool FloydStream(G& graph, const std::vector<int>* rows)
+{
+	int n = graph.getSize();
+	const D INF = std::numeric_limits<D>::max()/4;
+	std::vector<D> h, dist;
+	if(!potentials<G, Directed, D>(graph, h)){
+		cout << "========ERROR========\n";
+        cout << "800\n";
+        cout << "======================\n\n";
+		return false;
+	}
+	printFloydHeader(n, Directed);
+	for(size_t k=0;k<rowCount(rows, n);++k){
+		int oi = rowAt(rows, k);
+		sourceDistances<G, Directed, D>(graph, graph.toInternal(oi), h, dist);
+		PhaseTimer fmt(&g_Phases.formatMs);
+		printFloydRow(graph, oi, dist.data(), INF);
+	}
+	cout << "======================\n\n";
+	return true;
+}
+
+template<class G, class D>
+bool CentralityStream(G& graph)
+{
+	int n = graph.getSize();
+	const D INF = std::numeric_limits<D>::max()/4;
+	std::vector<D> h, dist;
+	if(!potentials<G, false, D>(graph, h)){
+		cout << "========ERROR========\n";
+        cout << "900\n";
+        cout << "======================\n\n";
+		return false;
+	}
+	std::vector<long long> denom(n, 0);
+	for(int u=0; u<n; ++u){
+		sourceDistances<G, false, D>(graph, u, h, dist);
+		denom[u] = distanceSum(dist.data(), n, u, INF);
+	}
+	return printCentrality(graph, denom);
+}
+
+// ---------- Distance width ----------
+bool fitsNarrowDistance(Graph* graph)
+{
+	// negative cycles can push Floyd / Bellman-Ford values far below any path bound
+	if(graph->getNegEdgeCount() > 0) return false;
+	long long w = graph->getEdgeCount() ? std::max(std::abs((long long)graph->getMinWeight()), std::abs((long long)graph->getMaxWeight())) : 0;
+	// a path has at most n-1 edges, and two paths are added before comparing
+	long long bound = 2LL * graph->getSize() * w;
+	return bound < std::numeric_limits<int>::max()/4;
+}
+
+// ---------- Instantiations ----------
+// every backend x view x distance width that Manager can dispatch to
+#define INSTANTIATE_VIEW(G, DIR) \
+	template bool BFS<G, DIR>(G&, int); \
+	template bool DFS<G, DIR>(G&, int); \
+	template bool Dijkstra<G, DIR, int>(G&, int, bool); \
+	template bool Dijkstra<G, DIR, long long>(G&, int, bool); \
+	template bool Bellmanford<G, DIR, int>(G&, int, int); \
+	template bool Bellmanford<G, DIR, long long>(G&, int, int); \
+	template bool FLOYD<G, DIR, int>(G&, DistMatrix&); \
+	template bool FLOYD<G, DIR, long long>(G&, DistMatrix&); \
+	template bool FloydStream<G, DIR, int>(G&, const std::vector<int>*); \
+	template bool FloydStream<G, DIR, long long>(G&, const std::vector<int>*);
+
+#define INSTANTIATE_BACKEND(G) \
+	INSTANTIATE_VIEW(G, true) \
+	INSTANTIATE_VIEW(G, false) \
+	template bool Kruskal<G>(G&, DynamicMST&); \
+	template bool Centrality<G, int>(G&); \
+	template bool Centrality<G, long long>(G&); \
+	template bool CentralityStream<G, int>(G&); \
+	template bool CentralityStream<G, long long>(G&);
+
+INSTANTIATE_BACKEND(ListGraph)
+INSTANTIATE_BACKEND(MatrixGraph)
+INSTANTIATE_BACKEND(CompressedGraph)
+INSTANTIATE_BACKEND(ExternalGraph)
+
+template bool ExternalBFS<true>(ExternalGraph&, int);
+template bool ExternalBFS<false>(ExternalGraph&, int);
+template bool ExternalBellmanford<true, int>(ExternalGraph&, int, int);
+template bool ExternalBellmanford<true, long long>(ExternalGraph&, int, int);
+template bool ExternalBellmanford<false, int>(ExternalGraph&, int, int);
+template bool ExternalBellmanford<false, long long>(ExternalGraph&, int, int);
@@ -3,14 +3,51 @@
 
 #include "ListGraph.h"
 #include "MatrixGraph.h"
+#include "CompressedGraph.h"
+#include "ExternalGraph.h"
+#include "DynamicMST.h"
+#include <limits>
+
+// unreachable in a DistMatrix
+const long long DIST_INF = std::numeric_limits<long long>::max()/4;
+
+// All-pairs distances kept between commands: written by FLOYD, patched by INSERT / UPDATE
+struct DistMatrix {
+	bool valid;
+	bool negCycle;              // FLOYD reports error 800
+	unsigned gen;               // Graph::getGeneration() the matrix is current for
+	std::vector<long long> d;   // n*n row-major, internal ids
+	DistMatrix() : valid(false), negCycle(false), gen(0) {}
+	void clear() { valid = false; negCycle = false; std::vector<long long>().swap(d); }
+};
 
 // Graph algorithms (all print to std::cout; Manager redirect to log.txt)
-bool BFS(Graph* graph, char option, int vertex);     
-bool DFS(Graph* graph, char option,  int vertex);     
-bool Centrality(Graph* graph);  
-bool Kruskal(Graph* graph);
-bool Dijkstra(Graph* graph, char option, int vertex);        // Dijkstra 
-bool Bellmanford(Graph* graph, char option, int s_vertex, int e_vertex); // Bellman-Ford
-bool FLOYD(Graph* graph, char option);                     
+// Specialized at compile time on
+//   G        concrete backend (ListGraph / MatrixGraph / CompressedGraph / ExternalGraph)
+//   Directed true = option 'O' (direct view), false = option 'X' (undirect view)
+//   D        distance type: int when fitsNarrowDistance(), else long long
+// Manager picks the instantiation once per command.
+template<class G, bool Directed> bool BFS(G& graph, int vertex);
+template<class G, bool Directed> bool DFS(G& graph, int vertex);
+template<class G, class D> bool Centrality(G& graph);
+template<class G> bool Kruskal(G& graph, DynamicMST& keep);  // tree retained in keep (cost is 64-bit)
+bool printKruskal(DynamicMST& t);  // KRUSKAL block from a retained tree
+template<class G, bool Directed, class D> bool Dijkstra(G& graph, int vertex, bool predOnly); // Dijkstra (predOnly: "[v] parent (dist)" lines)
+template<class G, bool Directed, class D> bool Bellmanford(G& graph, int s_vertex, int e_vertex); // Bellman-Ford
+template<class G, bool Directed, class D> bool FLOYD(G& graph, DistMatrix& keep); // result retained in keep
+bool printFloyd(Graph& graph, bool directed, const DistMatrix& m, const std::vector<int>* rows = nullptr); // FLOYD block from a retained matrix
+// Same output in O(n + m) memory: one Dijkstra per source over Johnson potentials,
+// only for the selected rows (see rowAt)
+template<class G, bool Directed, class D> bool FloydStream(G& graph, const std::vector<int>* rows);
+template<class G, class D> bool CentralityStream(G& graph);
+void relaxEdge(DistMatrix& m, int n, int u, int v, int w, bool directed); // O(n^2) patch after edge u->v got weight w (new or lower)
+
+// Out-of-core variants for ExternalGraph: vertex arrays in RAM, edges streamed from disk
+template<bool Directed> bool ExternalBFS(ExternalGraph& graph, int vertex);   // visited bitmap, one row read per vertex
+bool ExternalKruskal(ExternalGraph& graph, DynamicMST& keep);                 // external sort by weight + union-find
+template<bool Directed, class D> bool ExternalBellmanford(ExternalGraph& graph, int s_vertex, int e_vertex); // sequential edge passes
+
+// true if every distance sum the algorithms form fits in 32 bits
+bool fitsNarrowDistance(Graph* graph);
 
-#endif
\ No newline at end of file
+#endif
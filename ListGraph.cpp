@@ -1,15 +1,56 @@
 #include "ListGraph.h"
 #include <iostream>
 #include <utility>
+#include <vector>
+#include <algorithm>
 
 ListGraph::ListGraph(bool type, int size) : Graph(type, size)
 {
-	m_List = new std::map<int,int>[m_Size];
+	m_Rows = new Row[m_Size];
+	for(int i = 0; i < m_Size; ++i) { m_Rows[i].e = nullptr; m_Rows[i].size = 0; m_Rows[i].cap = 0; }
 }
 
 ListGraph::~ListGraph()	
 {
-	delete [] m_List;
+	// rows point into the arena, which frees its blocks in one go
+	delete [] m_Rows;
+}
+
+// lower bound of 'to' in row u, ordered by original id
+int ListGraph::findSlot(int u, int to)
+{
+	const Row& r = m_Rows[u];
+	int key = toOrig(to);
+	// fast path: LOAD inserts in ascending order
+	if(r.size == 0 || toOrig(r.e[r.size-1].to) < key) return r.size;
+	int lo = 0, hi = r.size;
+	while(lo < hi) {
+		int mid = (lo + hi) / 2;
+		if(toOrig(r.e[mid].to) < key) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+// double the row capacity; the old chunk stays in the arena until teardown
+void ListGraph::growRow(int u)
+{
+	Row& r = m_Rows[u];
+	int cap = r.cap ? r.cap * 2 : 2;
+	AdjEntry* e = (AdjEntry*)m_Arena.alloc(sizeof(AdjEntry) * cap);
+	if(r.size) memcpy(e, r.e, sizeof(AdjEntry) * r.size);
+	r.e = e;
+	r.cap = cap;
+}
+
+void ListGraph::reserveRow(int u, int count)
+{
+	if(u < 0 || u >= m_Size || count <= m_Rows[u].cap) return;
+	Row& r = m_Rows[u];
+	AdjEntry* e = (AdjEntry*)m_Arena.alloc(sizeof(AdjEntry) * count);
+	if(r.size) memcpy(e, r.e, sizeof(AdjEntry) * r.size);
+	r.e = e;
+	r.cap = count;
 }
 
 void ListGraph::getAdjacentEdges(int vertex, std::map<int, int>* out) // undirect view
@@ -18,16 +59,19 @@ void ListGraph::getAdjacentEdges(int vertex, std::map<int, int>* out) // undirec
 	if(vertex < 0 || vertex >= m_Size) return;
 
 	// 1) outgoing neighbor
-	for(const auto& kv : m_List[vertex]) {
-		(*out)[kv.first] = kv.second;
+	const Row& r = m_Rows[vertex];
+	for(int i = 0; i < r.size; ++i) {
+		(*out)[r.e[i].to] = r.e[i].w;
 	}
 	// 2) incoming neighbor
 	for(int u = 0; u < m_Size; ++u) {
-		auto it = m_List[u].find(vertex);
-		if(it != m_List[u].end()) {
+		int k = findSlot(u, vertex);
+		if(k < m_Rows[u].size && m_Rows[u].e[k].to == vertex) {
+			int w = m_Rows[u].e[k].w;
 			// avoid overriding 
-			if(out->find(u) == out->end()) (*out)[u] = it->second;
-			else (*out)[u] = std::min((*out)[u], it->second);
+			auto it = out->find(u);
+			if(it == out->end()) (*out)[u] = w;
+			else it->second = std::min(it->second, w);
 		}
 	}
 }
@@ -36,31 +80,72 @@ void ListGraph::getAdjacentEdgesDirect(int vertex, std::map<int, int>* out) // d
 {
 	out->clear();
 	if(vertex < 0 || vertex >= m_Size) return;
-	for(const auto& kv : m_List[vertex]) {
-		(*out)[kv.first] = kv.second;
+	const Row& r = m_Rows[vertex];
+	for(int i = 0; i < r.size; ++i) {
+		(*out)[r.e[i].to] = r.e[i].w;
 	}
 }
 
+// row is already in original id order, plain copy
+void ListGraph::getOutEdges(int vertex, std::vector<std::pair<int, int>>* out)
+{
+	out->clear();
+	if(vertex < 0 || vertex >= m_Size) return;
+	const Row& r = m_Rows[vertex];
+	out->reserve(r.size);
+	for(int i = 0; i < r.size; ++i) out->push_back(std::make_pair(r.e[i].to, r.e[i].w));
+}
+
 void ListGraph::insertEdge(int from, int to, int weight)
 {
 	if(from < 0 || from >= m_Size || to < 0 || to >= m_Size) return;
-	m_List[from][to] = weight;
+	Row& r = m_Rows[from];
+	int k = findSlot(from, to);
+	// overwrite = reweight of the same edge
+	if(k < r.size && r.e[k].to == to) {
+		if(r.e[k].w != weight) {
+			noteReweight(r.e[k].w, weight);
+			r.e[k].w = weight;
+		}
+		return;
+	}
+	// new edge: shift the tail and keep the row sorted
+	if(r.size == r.cap) growRow(from);
+	if(k < r.size) memmove(r.e + k + 1, r.e + k, sizeof(AdjEntry) * (r.size - k));
+	r.e[k].to = to;
+	r.e[k].w = weight;
+	r.size++;
+	noteInsert(from, to, weight);
+}
+
+// binary search in the sorted row
+bool ListGraph::getEdge(int from, int to, int* weight)
+{
+	if(from < 0 || from >= m_Size || to < 0 || to >= m_Size) return false;
+	const Row& r = m_Rows[from];
+	int k = findSlot(from, to);
+	if(k >= r.size || r.e[k].to != to) return false;
+	*weight = r.e[k].w;
+	return true;
 }
 
-bool ListGraph::printGraph(std::ofstream *fout)
+bool ListGraph::printGraph(std::ofstream *fout, const std::vector<int>* rows)
 {
 	if(!fout || !fout->is_open()) return false;
+	// loaded from a matrix file: print it back as a matrix
+	if(m_Format != 'L') return Graph::printGraph(fout, rows);
 
 	(*fout) << "========PRINT=======\n";
-	for(int u = 0; u < m_Size; ++u) {
-		(*fout) << "[" << u << "]";
-		if(!m_List[u].empty()) {
+	// rows in original id order, neighbors are stored that way already
+	for(size_t k = 0; k < rowCount(rows, m_Size); ++k) {
+		int o = rowAt(rows, k);
+		const Row& r = m_Rows[toInternal(o)];
+		(*fout) << "[" << o << "]";
+		if(r.size) {
 			(*fout) << " -> ";
-			bool first = true;
-			for(const auto& kv : m_List[u]) {
-				if(!first) (*fout) << " -> ";
-				first = false;
-				(*fout) << "(" << kv.first << "," << kv.second << ")";
+			for(int i = 0; i < r.size; ++i) {
+				if(i) (*fout) << " -> ";
+				(*fout) << "(" << toOrig(r.e[i].to) << "," << r.e[i].w << ")";
 			}
 		}
 		(*fout) << "\n";
@@ -68,3 +153,8 @@ bool ListGraph::printGraph(std::ofstream *fout)
 	(*fout) << "======================\n\n";
 	return true;
 }
+
+size_t ListGraph::getMemoryBytes()
+{
+	return Graph::getMemoryBytes() + sizeof(Row) * m_Size + m_Arena.getReserved();
+}
@@ -2,11 +2,19 @@
 #define _LIST_H_
 
 #include "Graph.h"
+#include "Arena.h"
 
 class ListGraph : public Graph{	
 private:
-	// adjacency list: m_List[u][v] = weight 
-	std::map<int, int>* m_List;
+	// adjacency row of one vertex: sorted by original id of 'to', storage in m_Arena
+	struct Row { AdjEntry* e; int size; int cap; };
+
+	Row* m_Rows;      // m_Rows[u] = out edges of u
+	Arena m_Arena;    // backing store of every row
+
+	// position of 'to' in row u (or insertion point)
+	int findSlot(int u, int to);
+	void growRow(int u);
 
 public:	
 	ListGraph(bool type, int size);
@@ -14,8 +22,20 @@ public:
 		
 	void getAdjacentEdges(int vertex, std::map<int, int>* m) override;	    // undirect view
 	void getAdjacentEdgesDirect(int vertex, std::map<int, int>* m) override; // direct view
+	void getOutEdges(int vertex, std::vector<std::pair<int, int>>* out) override;
 	void insertEdge(int from, int to, int weight) override;	
-	bool printGraph(std::ofstream *fout) override;
+	bool getEdge(int from, int to, int* weight) override;
+	// presize row u (LOAD knows the degrees), avoids regrowth slack in the arena
+	void reserveRow(int u, int count);
+	bool printGraph(std::ofstream *fout, const std::vector<int>* rows = nullptr) override;
+	size_t getMemoryBytes() override;
+
+	// Static iteration for the kernels in GraphMethod.cpp: f(v, w), ascending original id
+	template<class F> void forEachOut(int u, F f) {
+		const Row& r = m_Rows[u];
+		for(int i = 0; i < r.size; ++i) f(r.e[i].to, r.e[i].w);
+	}
+	template<class F> void forEachUndir(int u, F f) { forEachSym(u, f); }
 };
 
-#endif
\ No newline at end of file
+#endif
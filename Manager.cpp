@@ -6,13 +6,18 @@
 #include <string>
 #include <sstream>
 #include <cctype>
+#include <algorithm>
+#include <climits>
+#include <cerrno>
+#include <cstdlib>
 
-Manager::Manager()	
+Manager::Manager(const char* log_txt)	
 {
 	graph = nullptr;	
 	// overwrite log.txt 
-	fout.open("log.txt", ios::out | ios::trunc); //save as newthing
+	fout.open(log_txt, ios::out | ios::trunc); //save as newthing
 	load = 0;
+	memLimit = 0;
 }
 
 Manager::~Manager()
@@ -21,6 +26,10 @@ Manager::~Manager()
 	if(fout.is_open()) fout.close();
 }
 
+Graph* Manager::getGraph(){ return load ? graph : nullptr; }
+
+void Manager::dropRetained(){ apsp[0].clear(); apsp[1].clear(); mst.clear(); }
+
 static std::vector<std::string> splitTokens(const std::string& line){
 	std::stringstream ss(line);
 	std::vector<std::string> t;
@@ -29,6 +38,77 @@ static std::vector<std::string> splitTokens(const std::string& line){
 	return t;
 }
 
+// whole token is a base-10 int
+static bool parseInt(const std::string& s, int* out)
+{
+	if(s.empty()) return false;
+	char* end = nullptr;
+	errno = 0;
+	long x = strtol(s.c_str(), &end, 10);
+	if(*end != '\0' || errno == ERANGE || x < INT_MIN || x > INT_MAX) return false;
+	*out = (int)x;
+	return true;
+}
+
+static bool parseBackend(const std::string& s, Backend* b)
+{
+	if(s == "AUTO") *b = BACKEND_AUTO;
+	else if(s == "LIST") *b = BACKEND_LIST;
+	else if(s == "MATRIX") *b = BACKEND_MATRIX;
+	else if(s == "COMPRESSED") *b = BACKEND_COMPRESSED;
+	else if(s == "EXTERNAL") *b = BACKEND_EXTERNAL;
+	else return false;
+	return true;
+}
+
+// "a", "a-b" items separated by commas, appended to rows.
+// *ok = false if a range falls outside [0, n); false if s is not a range list at all.
+static bool parseRangeList(const std::string& s, int n, std::vector<int>* rows, bool* ok)
+{
+	if(s.find_first_not_of("0123456789-,") != std::string::npos) return false;
+	std::stringstream ss(s);
+	std::string item;
+	int items = 0;
+	while(std::getline(ss, item, ',')){
+		size_t dash = item.find('-');
+		int a, b;
+		if(dash == std::string::npos){
+			if(!parseInt(item, &a)) return false;
+			b = a;
+		}else if(!parseInt(item.substr(0, dash), &a) || !parseInt(item.substr(dash + 1), &b) || a > b) return false;
+		if(a < 0 || b >= n) *ok = false;
+		else for(int v = a; v <= b; ++v) rows->push_back(v);
+		items++;
+	}
+	return items > 0;
+}
+
+// Row selection tokens of PRINT / FLOYD: each one a range list ("0-9,15")
+// or a file of whitespace separated vertex ids. Sorted, duplicates dropped;
+// false if anything is malformed, missing or out of [0, n).
+static bool parseRows(const std::vector<std::string>& tk, size_t first, int n, std::vector<int>* rows)
+{
+	rows->clear();
+	bool ok = true;
+	for(size_t i = first; i < tk.size() && ok; ++i){
+		size_t mark = rows->size();
+		if(parseRangeList(tk[i], n, rows, &ok)) continue;
+		rows->resize(mark);   // not a range list after all: a vertex file
+		std::ifstream vin(tk[i]);
+		if(!vin) return false;
+		std::string w;
+		int v;
+		while(ok && vin >> w){
+			if(!parseInt(w, &v) || v < 0 || v >= n) ok = false;
+			else rows->push_back(v);
+		}
+	}
+	if(!ok) return false;
+	std::sort(rows->begin(), rows->end());
+	rows->erase(std::unique(rows->begin(), rows->end()), rows->end());
+	return !rows->empty();
+}
+
 void Manager::run(const char* command_txt){
 	ifstream fin;
 	fin.open(command_txt, ios_base::in);
@@ -43,97 +123,147 @@ void Manager::run(const char* command_txt){
 		auto tk = splitTokens(line);
 		if(tk.empty()) continue;
 
-		std::string cmd = tk[0];
-
-		// All commands are uppercase as per spec
-		if(cmd == "LOAD"){
-			if(tk.size() != 2){ printErrorCode(100); continue; }
-			LOAD(tk[1].c_str());
-		}
-		else if(cmd == "PRINT"){
-			if(tk.size() != 1){ printErrorCode(200); continue; }
-			PRINT();
-		}
-		else if(cmd == "BFS"){
-			if(tk.size() != 3){ printErrorCode(300); continue; }
-			char opt = tk[1][0];
-			int s = std::stoi(tk[2]);
-			if(!(opt=='O'||opt=='X')){ printErrorCode(300); continue; }
-			mBFS(opt, s);
-		}
-		else if(cmd == "DFS"){
-			if(tk.size() != 3){ printErrorCode(400); continue; }
-			char opt = tk[1][0];
-			int s = std::stoi(tk[2]);
-			if(!(opt=='O'||opt=='X')){ printErrorCode(400); continue; }
-			mDFS(opt, s);
-		}
-		else if(cmd == "KRUSKAL"){
-			if(tk.size() != 1){ printErrorCode(500); continue; }
-			mKRUSKAL();
-		}
-		else if(cmd == "DIJKSTRA"){
-			if(tk.size() != 3){ printErrorCode(600); continue; }
-			char opt = tk[1][0];
-			int s = std::stoi(tk[2]);
-			if(!(opt=='O'||opt=='X')){ printErrorCode(600); continue; }
-			mDIJKSTRA(opt, s);
-		}
-		else if(cmd == "BELLMANFORD"){
-			if(tk.size() != 4){ printErrorCode(700); continue; }
-			char opt = tk[1][0];
-			int s = std::stoi(tk[2]);
-			int e = std::stoi(tk[3]);
-			if(!(opt=='O'||opt=='X')){ printErrorCode(700); continue; }
-			mBELLMANFORD(opt, s, e);
-		}
-		else if(cmd == "FLOYD"){
-			if(tk.size() != 2){ printErrorCode(800); continue; }
-			char opt = tk[1][0];
-			if(!(opt=='O'||opt=='X')){ printErrorCode(800); continue; }
-			mFLOYD(opt);
-		}
-		else if(cmd == "CENTRALITY"){
-			if(tk.size() != 1){ printErrorCode(900); continue; }
-			mCentrality();
-		}
-		else if(cmd == "EXIT"){
-			// Always success
-			fout << "========EXIT========\n";
-			fout << "Success\n";
-			fout << "======================\n\n";
-			break;
-		}
+		// every command is timed and counted for STATS / TRACE
+		stats.begin(getGraph());
+		bool go = runCommand(tk);
+		stats.end(tk[0], getGraph());
+		if(!go) break;
 	}
 	fin.close();
 	return;
 }
 
-bool Manager::LOAD(const char* filename)
-{
-	// delete previous
-	if(load){ delete graph; graph=nullptr; load=0; }
+// one command line; false on EXIT
+bool Manager::runCommand(const std::vector<std::string>& tk){
+	std::string cmd = tk[0];
 
-	std::ifstream gin(filename);
-	if(!gin){
-		printErrorCode(100);
-		return false;
+	// All commands are uppercase as per spec
+	if(cmd == "LOAD"){
+		// optional tokens: relabeling mode (BFS | RCM | DEGREE),
+		// backend override (AUTO | LIST | MATRIX | COMPRESSED | EXTERNAL)
+		if(tk.size() < 2 || tk.size() > 4){ printErrorCode(100); return true; }
+		ReorderMode mode = REORDER_NONE;
+		Backend backend = BACKEND_AUTO;
+		bool hasBackend = false, bad = false;
+		for(size_t i = 2; i < tk.size(); ++i){
+			if(!hasBackend && parseBackend(tk[i], &backend)) hasBackend = true;
+			else if(mode == REORDER_NONE && parseReorderMode(tk[i], &mode)) continue;
+			else bad = true;
+		}
+		if(bad){ printErrorCode(100); return true; }
+		LOAD(tk[1].c_str(), mode, backend);
 	}
-	char type_char='L';
-	int n=0;
-	gin >> type_char;
-	gin >> n;
-	if(!gin || n<=0){
-		printErrorCode(100);
+	else if(cmd == "PRINT"){
+		// optional row selection: PRINT 0-9,15 / PRINT rows.txt
+		if(tk.size() == 1){ PRINT(); return true; }
+		std::vector<int> rows;
+		if(!load || !parseRows(tk, 1, graph->getSize(), &rows)){ printErrorCode(200); return true; }
+		PRINT(&rows);
+	}
+	else if(cmd == "BFS"){
+		if(tk.size() != 3){ printErrorCode(300); return true; }
+		char opt = tk[1][0];
+		int s = std::stoi(tk[2]);
+		if(!(opt=='O'||opt=='X')){ printErrorCode(300); return true; }
+		mBFS(opt, s);
+	}
+	else if(cmd == "DFS"){
+		if(tk.size() != 3){ printErrorCode(400); return true; }
+		char opt = tk[1][0];
+		int s = std::stoi(tk[2]);
+		if(!(opt=='O'||opt=='X')){ printErrorCode(400); return true; }
+		mDFS(opt, s);
+	}
+	else if(cmd == "KRUSKAL"){
+		if(tk.size() != 1){ printErrorCode(500); return true; }
+		mKRUSKAL();
+	}
+	else if(cmd == "DIJKSTRA"){
+		// optional 4th token PRED: predecessor list instead of full paths
+		if(tk.size() != 3 && tk.size() != 4){ printErrorCode(600); return true; }
+		if(tk.size() == 4 && tk[3] != "PRED"){ printErrorCode(600); return true; }
+		char opt = tk[1][0];
+		int s = std::stoi(tk[2]);
+		if(!(opt=='O'||opt=='X')){ printErrorCode(600); return true; }
+		mDIJKSTRA(opt, s, tk.size() == 4);
+	}
+	else if(cmd == "BELLMANFORD"){
+		if(tk.size() != 4){ printErrorCode(700); return true; }
+		char opt = tk[1][0];
+		int s = std::stoi(tk[2]);
+		int e = std::stoi(tk[3]);
+		if(!(opt=='O'||opt=='X')){ printErrorCode(700); return true; }
+		mBELLMANFORD(opt, s, e);
+	}
+	else if(cmd == "FLOYD"){
+		// optional source rows after the option, same forms as PRINT
+		if(tk.size() < 2){ printErrorCode(800); return true; }
+		char opt = tk[1][0];
+		if(!(opt=='O'||opt=='X')){ printErrorCode(800); return true; }
+		if(tk.size() == 2){ mFLOYD(opt); return true; }
+		std::vector<int> rows;
+		if(!load || !parseRows(tk, 2, graph->getSize(), &rows)){ printErrorCode(800); return true; }
+		mFLOYD(opt, &rows);
+	}
+	else if(cmd == "CENTRALITY"){
+		if(tk.size() != 1){ printErrorCode(900); return true; }
+		mCentrality();
+	}
+	else if(cmd == "EXIT"){
+		// Always success
+		fout << "========EXIT========\n";
+		fout << "Success\n";
+		fout << "======================\n\n";
 		return false;
 	}
+	else if(cmd == "STATS"){
+		if(tk.size() != 1){ printErrorCode(1000); return true; }
+		STATS();
+	}
+	else if(cmd == "TRACE"){
+		// TRACE <file> starts a per-command CSV trace, TRACE OFF stops it
+		if(tk.size() != 2){ printErrorCode(1100); return true; }
+		TRACE(tk[1].c_str());
+	}
+	else if(cmd == "INSERT" || cmd == "UPDATE"){
+		// INSERT u v w adds a new edge, UPDATE u v w reweights an existing one
+		int code = cmd == "INSERT" ? 1300 : 1400;
+		if(tk.size() != 4){ printErrorCode(code); return true; }
+		int u, v, w;
+		if(!parseInt(tk[1], &u) || !parseInt(tk[2], &v) || !parseInt(tk[3], &w)){ printErrorCode(code); return true; }
+		if(cmd == "INSERT") mINSERT(u, v, w);
+		else mUPDATE(u, v, w);
+	}
+	else if(cmd == "MEMLIMIT"){
+		// MEMLIMIT <MB>: budget for LOAD AUTO and the out-of-core sort blocks
+		int mb;
+		if(tk.size() != 2 || !parseInt(tk[1], &mb)){ printErrorCode(1200); return true; }
+		MEMLIMIT(mb);
+	}
+	return true;
+}
 
-	if(type_char=='L') graph = new ListGraph(false, n);
-	else graph = new MatrixGraph(true, n);
+// A matrix costs 4n^2 bytes and O(n) per neighbor scan, a list about 8 bytes
+// per edge and O(deg): the matrix only pays off once a quarter of all pairs are edges.
+static const double MATRIX_MIN_DENSITY = 0.25;
 
-	// consume endline
-	std::string rest;
-	std::getline(gin, rest);
+static Backend chooseBackend(int n, size_t m, bool zeroWeight)
+{
+	double density = (double)m / ((double)n * n);
+	// weight 0 means "no edge" in a matrix
+	if(!zeroWeight && density >= MATRIX_MIN_DENSITY) return BACKEND_MATRIX;
+	return BACKEND_LIST;
+}
+
+// Read every edge of the body (after the "L n" / "M n" header) into sink(from, to, w).
+// Out of range ids are dropped, like insertEdge does.
+template<class Sink>
+static bool readEdges(std::ifstream& gin, char type_char, int n, Sink sink)
+{
+	auto addEdge = [&sink, n](int from, int to, int w){
+		if(from < 0 || from >= n || to < 0 || to >= n) return;
+		sink(from, to, w);
+	};
 
 	if(type_char=='L'){
 		// Robust parser for adjacency list:
@@ -154,15 +284,9 @@ bool Manager::LOAD(const char* filename)
 				if(current_from==-1){
 					// treat first as from, rest as pairs
 					int from = nums[0];
-					for(size_t i=1;i+1<nums.size(); i+=2){
-						int to=nums[i], w=nums[i+1];
-						graph->insertEdge(from, to, w);
-					}
+					for(size_t i=1;i+1<nums.size(); i+=2) addEdge(from, nums[i], nums[i+1]);
 				}else{
-					for(size_t i=0;i+1<nums.size(); i+=2){
-						int to=nums[i], w=nums[i+1];
-						graph->insertEdge(current_from, to, w);
-					}
+					for(size_t i=0;i+1<nums.size(); i+=2) addEdge(current_from, nums[i], nums[i+1]);
 					current_from = -1; // optional
 				}
 			}
@@ -171,12 +295,185 @@ bool Manager::LOAD(const char* filename)
 		for(int i=0;i<n;++i){
 			for(int j=0;j<n;++j){
 				int w=0; gin >> w;
-				if(!gin){ printErrorCode(100); return false; }
-				if(w!=0) graph->insertEdge(i,j,w);
+				if(!gin) return false;
+				if(w!=0) addEdge(i,j,w);
 			}
 		}
 	}
+	return true;
+}
+
+// input size in bytes, -1 if unknown
+static long long fileBytes(const char* filename)
+{
+	std::ifstream f(filename, std::ios::binary | std::ios::ate);
+	return f ? (long long)f.tellg() : -1;
+}
+
+// budget for the out-of-core sort blocks: half the limit, the kernels' vertex arrays need the rest
+static size_t externalBudget(size_t memLimit)
+{
+	return memLimit ? memLimit / 2 : EXTERNAL_DEFAULT_BUDGET;
+}
+
+// storage a backend will allocate for n vertices and m edges (LOAD admission)
+static size_t graphBytes(Backend b, size_t n, size_t m)
+{
+	switch(b){
+	case BACKEND_MATRIX:
+		return n * n * sizeof(int) + n * sizeof(int*);
+	case BACKEND_COMPRESSED:
+		// sort buffer of build() + encoded rows (a few bytes per edge) + offsets
+		return m * (sizeof(Edge) + 6) + (n + 1) * 2 * sizeof(uint64_t) + n * sizeof(int);
+	case BACKEND_EXTERNAL:
+		return n * sizeof(uint64_t);
+	default:
+		// presized rows + row headers
+		return m * sizeof(AdjEntry) + n * (sizeof(AdjEntry*) + 2 * sizeof(int));
+	}
+}
+
+// held between commands: the graph and the retained FLOYD / KRUSKAL results
+size_t Manager::residentBytes()
+{
+	size_t bytes = load ? graph->getMemoryBytes() : 0;
+	for(int k = 0; k < 2; ++k) bytes += apsp[k].d.capacity() * sizeof(long long);
+	return bytes + mst.getMemoryBytes();
+}
+
+bool Manager::fitsBudget(size_t need)
+{
+	stats.noteEstimate(need);
+	return !memLimit || residentBytes() + need <= memLimit;
+}
+
+bool Manager::LOAD(const char* filename, ReorderMode reorder, Backend backend)
+{
+	// delete previous
+	if(load){ delete graph; graph=nullptr; load=0; }
+	dropRetained();
+
+	std::ifstream gin(filename);
+	if(!gin){
+		printErrorCode(100);
+		return false;
+	}
+	char type_char='L';
+	int n=0;
+	gin >> type_char;
+	gin >> n;
+	if(!gin || n<=0){
+		printErrorCode(100);
+		return false;
+	}
+
+	// consume endline
+	std::string rest;
+	std::getline(gin, rest);
+
+	// under a MEMLIMIT, AUTO keeps inputs larger than the limit on disk
+	// (the text form is already smaller than any in-memory backend)
+	if(backend == BACKEND_AUTO && memLimit && fileBytes(filename) > (long long)memLimit) backend = BACKEND_EXTERNAL;
+	if(backend == BACKEND_EXTERNAL) return loadExternal(gin, type_char, n, reorder);
+
+	// 1) parse every edge first
+	std::vector<Edge> edges;
+	bool ok;
+	{
+		PhaseTimer t(&g_Phases.parseMs);
+		ok = readEdges(gin, type_char, n, [&edges](int u, int v, int w){ edges.push_back({u, v, w}); });
+	}
+	if(!ok){
+		printErrorCode(100);
+		return false;
+	}
+
+	// 2) pick the backend from the measured density unless overridden
+	bool zeroWeight = false;
+	for(const auto& e : edges) if(e.w == 0) { zeroWeight = true; break; }
+	bool autoBackend = backend == BACKEND_AUTO;
+	if(autoBackend) backend = chooseBackend(n, edges.size(), zeroWeight);
+	if(backend == BACKEND_MATRIX && zeroWeight){
+		printErrorCode(100);
+		return false;
+	}
+	// the parsed edges stay alive while the graph is built; a dense pick that does not fit falls back to a list
+	size_t parsed = edges.capacity() * sizeof(Edge);
+	if(autoBackend && backend == BACKEND_MATRIX && !fitsBudget(parsed + graphBytes(backend, n, edges.size())))
+		backend = BACKEND_LIST;
+	if(!fitsBudget(parsed + graphBytes(backend, n, edges.size()))){
+		printErrorCode(100);
+		return false;
+	}
+
+	// 3) build the graph; relabeling only applies to the list forms
+	PhaseTimer t(&g_Phases.buildMs);
+	if(backend == BACKEND_COMPRESSED) graph = new CompressedGraph(false, n);
+	else if(backend == BACKEND_LIST) graph = new ListGraph(false, n);
+	else graph = new MatrixGraph(true, n);
+	graph->setFormat(type_char=='L' ? 'L' : 'M');
+
+	if(backend != BACKEND_MATRIX && reorder != REORDER_NONE){
+		std::vector<int> toInternal;
+		computeOrder(n, edges, reorder, &toInternal);
+		graph->setOrder(toInternal);
+	}
+	if(backend == BACKEND_COMPRESSED){
+		// read-only: encoded in one pass
+		static_cast<CompressedGraph*>(graph)->build(edges);
+	}else{
+		if(backend == BACKEND_LIST){
+			// rows are sorted arrays: size each row once, then feed it in ascending
+			// order so inserts are appends (stable: a repeated edge still overwrites)
+			ListGraph* lg = static_cast<ListGraph*>(graph);
+			std::vector<int> deg(n, 0);
+			for(const auto& e : edges) deg[e.u]++;
+			for(int u = 0; u < n; ++u) lg->reserveRow(graph->toInternal(u), deg[u]);
+			std::stable_sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b){
+				return a.u != b.u ? a.u < b.u : a.v < b.v;
+			});
+		}
+		for(const auto& e : edges) graph->insertEdge(graph->toInternal(e.u), graph->toInternal(e.v), e.w);
+	}
+	noteWorkBytes(parsed);   // the parse buffer is freed on return
+
+	load = 1;
+	fout << "========LOAD========\n";
+	fout << "Success\n";
+	fout << "======================\n\n";
+	return true;
+}
+
+// out-of-core LOAD: edges go straight from the parser into the on-disk sort
+bool Manager::loadExternal(std::ifstream& gin, char type_char, int n, ReorderMode reorder)
+{
+	// relabeling needs the whole edge set in memory
+	if(reorder != REORDER_NONE){
+		printErrorCode(100);
+		return false;
+	}
+	if(!fitsBudget(graphBytes(BACKEND_EXTERNAL, n, 0) + externalBudget(memLimit))){
+		printErrorCode(100);
+		return false;
+	}
+	ExternalGraph* xg = new ExternalGraph(false, n, externalBudget(memLimit));
+	xg->setFormat(type_char=='L' ? 'L' : 'M');
+	bool ok;
+	{
+		PhaseTimer t(&g_Phases.parseMs);
+		ok = readEdges(gin, type_char, n, [xg](int u, int v, int w){ xg->addEdge(u, v, w); });
+	}
+	if(ok){
+		PhaseTimer t(&g_Phases.buildMs);
+		ok = xg->seal();
+	}
+	if(!ok){
+		delete xg;
+		printErrorCode(100);
+		return false;
+	}
 
+	graph = xg;
 	load = 1;
 	fout << "========LOAD========\n";
 	fout << "Success\n";
@@ -184,55 +481,195 @@ bool Manager::LOAD(const char* filename)
 	return true;
 }
 
-bool Manager::PRINT()	
+bool Manager::PRINT(const std::vector<int>* rows)	
 {
 	if(!load){
 		printErrorCode(200);
 		return false;
 	}
-	// Graph classes handle full block printing
-	return graph->printGraph(&fout);
+	// Graph classes handle block printing, row by row (only the selected ones)
+	PhaseTimer t(&g_Phases.formatMs);
+	return graph->printGraph(&fout, rows);
 }
 
 static bool checkStartVertex(Graph* g, int v){
 	return v>=0 && v<g->getSize();
 }
 
-bool Manager::mBFS(char option, int vertex)	
+// ---------- kernel dispatch ----------
+// The algorithms are templates over backend, view and distance width;
+// this is the only place where the runtime graph picks one of them.
+template<class G, bool Dir, class D>
+static bool runKernel(G& g, Algo algo, const AlgoArgs& a)
 {
-	if(!load || !checkStartVertex(graph, vertex)){
-		printErrorCode(300);
+	switch(algo){
+	case ALGO_BFS:         return BFS<G, Dir>(g, a.s);
+	case ALGO_DFS:         return DFS<G, Dir>(g, a.s);
+	case ALGO_DIJKSTRA:    return Dijkstra<G, Dir, D>(g, a.s, a.predOnly);
+	case ALGO_BELLMANFORD: return Bellmanford<G, Dir, D>(g, a.s, a.e);
+	case ALGO_FLOYD:       return a.stream ? FloydStream<G, Dir, D>(g, a.rows) : FLOYD<G, Dir, D>(g, *a.keep);
+	case ALGO_KRUSKAL:     return Kruskal<G>(g, *a.tree);
+	case ALGO_CENTRALITY:  return a.stream ? CentralityStream<G, D>(g) : Centrality<G, D>(g);
+	}
+	return false;
+}
+
+template<class G, class D>
+static bool runView(G& g, Algo algo, const AlgoArgs& a)
+{
+	if(a.option == 'O') return runKernel<G, true, D>(g, algo, a);
+	return runKernel<G, false, D>(g, algo, a);
+}
+
+template<class G>
+static bool runWidth(G& g, Algo algo, const AlgoArgs& a, bool narrow)
+{
+	if(narrow) return runView<G, int>(g, algo, a);
+	return runView<G, long long>(g, algo, a);
+}
+
+// out-of-core graph: streaming variants where they exist, row reads otherwise
+static bool runExternal(ExternalGraph& g, Algo algo, const AlgoArgs& a, bool narrow)
+{
+	bool dir = a.option == 'O';
+	switch(algo){
+	case ALGO_BFS:
+		return dir ? ExternalBFS<true>(g, a.s) : ExternalBFS<false>(g, a.s);
+	case ALGO_KRUSKAL:
+		return ExternalKruskal(g, *a.tree);
+	case ALGO_BELLMANFORD:
+		if(narrow) return dir ? ExternalBellmanford<true, int>(g, a.s, a.e) : ExternalBellmanford<false, int>(g, a.s, a.e);
+		return dir ? ExternalBellmanford<true, long long>(g, a.s, a.e) : ExternalBellmanford<false, long long>(g, a.s, a.e);
+	default:
+		return runWidth(g, algo, a, narrow);
+	}
+}
+
+// error code of each command (also used when admission rejects it)
+static int algoErrorCode(Algo algo)
+{
+	switch(algo){
+	case ALGO_BFS:         return 300;
+	case ALGO_DFS:         return 400;
+	case ALGO_KRUSKAL:     return 500;
+	case ALGO_DIJKSTRA:    return 600;
+	case ALGO_BELLMANFORD: return 700;
+	case ALGO_FLOYD:       return 800;
+	case ALGO_CENTRALITY:  return 900;
+	}
+	return 0;
+}
+
+// Peak working set of one command in bytes, graph storage excluded (already resident).
+// Sized like the buffers the kernels report (noteWorkBytes), from n, the edges the view
+// yields and the distance width; stream selects the per-source engine of FLOYD / CENTRALITY.
+static size_t workingBytes(Graph* g, Algo algo, bool directed, bool narrow, bool stream)
+{
+	size_t n = g->getSize();
+	size_t m = (size_t)g->getEdgeCount() * (directed ? 1 : 2);
+	size_t d = narrow ? sizeof(int) : sizeof(long long);
+	size_t hp = narrow ? sizeof(std::pair<int,int>) : sizeof(std::pair<long long,int>);   // heap entry
+	size_t view = directed ? 0 : g->getPendingUndirectedBytes();
+	ExternalGraph* xg = dynamic_cast<ExternalGraph*>(g);
+	size_t scc = directed ? g->getPendingSccBytes() : 0;   // reachability index for pruning
+	// lazy Dijkstra heap: at most m + 1 entries, in practice about 2n (stale entries included)
+	size_t heap = std::min(m + 1, 2 * n);
+
+	switch(algo){
+	case ALGO_BFS:
+		return view + n * (1 + sizeof(int));                                  // visited + order
+	case ALGO_DFS:
+		return view + n * (1 + 2 * sizeof(int)) + m * sizeof(int);            // + stack of pending neighbors
+	case ALGO_DIJKSTRA:
+		return view + n * (d + 2 * sizeof(int)) + heap * hp;                  // dist, parent, path stack, heap
+	case ALGO_BELLMANFORD:
+		return view + (xg ? 0 : scc + m * sizeof(Edge)) + n * (d + sizeof(int));   // external: streamed passes
+	case ALGO_KRUSKAL:
+		// pair list (or the external sort), then per tree edge (about n): DSU, tree + retained
+		// tree (slot + index node), and a print list per vertex holding both ends of each edge
+		return view + (xg ? xg->getBudget() : (m / 2 + n) * sizeof(Edge))
+			+ n * (2 * sizeof(int) + 2 * sizeof(Edge) + DynamicMST::SLOT_NODE_BYTES
+				+ sizeof(std::vector<std::pair<int,int>>) + 2 * sizeof(std::pair<int,int>));
+	case ALGO_FLOYD:
+		if(stream) return view + n * 2 * d + heap * hp;                        // potentials, one row, heap
+		return view + scc + n * n * (d + sizeof(long long));                   // matrix + retained copy
+	case ALGO_CENTRALITY:
+		if(stream) return view + n * (2 * d + sizeof(long long)) + heap * hp;
+		return view + n * n * d + n * sizeof(long long);
+	}
+	return view;
+}
+
+bool Manager::runAlgo(Algo algo, const AlgoArgs& a)
+{
+	bool narrow = fitsNarrowDistance(graph);
+	bool dir = a.option == 'O';
+
+	// admission: FLOYD / CENTRALITY switch to the per-source engine before giving up
+	AlgoArgs b = a;
+	bool fits = fitsBudget(workingBytes(graph, algo, dir, narrow, a.stream));
+	if(!fits && !a.stream && (algo == ALGO_FLOYD || algo == ALGO_CENTRALITY)){
+		b.stream = true;
+		fits = fitsBudget(workingBytes(graph, algo, dir, narrow, true));
+	}
+	if(!fits){
+		printErrorCode(algoErrorCode(algo));
 		return false;
 	}
+
+	// the out-of-core undirected view is written on first use: an I/O error fails the command
+	ExternalGraph* xg = dynamic_cast<ExternalGraph*>(graph);
+	if(xg && !dir && !xg->prepareUndirected()){
+		printErrorCode(algoErrorCode(algo));
+		return false;
+	}
+
 	// redirect cout to fout while GraphMethod prints
 	std::streambuf* bak = std::cout.rdbuf(fout.rdbuf());
-	bool ok = BFS(graph, option, vertex);
+	bool ok = false;
+	if(ListGraph* lg = dynamic_cast<ListGraph*>(graph)) ok = runWidth(*lg, algo, b, narrow);
+	else if(MatrixGraph* mg = dynamic_cast<MatrixGraph*>(graph)) ok = runWidth(*mg, algo, b, narrow);
+	else if(CompressedGraph* cg = dynamic_cast<CompressedGraph*>(graph)) ok = runWidth(*cg, algo, b, narrow);
+	else if(xg) ok = runExternal(*xg, algo, b, narrow);
 	std::cout.rdbuf(bak);
 	return ok;
 }
 
+static AlgoArgs makeArgs(char option, int s, int e, bool predOnly){
+	AlgoArgs a;
+	a.option = option; a.s = s; a.e = e; a.predOnly = predOnly;
+	a.keep = nullptr;
+	a.tree = nullptr;
+	a.stream = false;
+	a.rows = nullptr;
+	return a;
+}
+
+bool Manager::mBFS(char option, int vertex)	
+{
+	if(!load || !checkStartVertex(graph, vertex)){
+		printErrorCode(300);
+		return false;
+	}
+	return runAlgo(ALGO_BFS, makeArgs(option, vertex, 0, false));
+}
+
 bool Manager::mDFS(char option, int vertex)	
 {
 	if(!load || !checkStartVertex(graph, vertex)){
 		printErrorCode(400);
 		return false;
 	}
-	std::streambuf* bak = std::cout.rdbuf(fout.rdbuf());
-	bool ok = DFS(graph, option, vertex);
-	std::cout.rdbuf(bak);
-	return ok;
+	return runAlgo(ALGO_DFS, makeArgs(option, vertex, 0, false));
 }
 
-bool Manager::mDIJKSTRA(char option, int vertex)	
+bool Manager::mDIJKSTRA(char option, int vertex, bool predOnly)	
 {
 	if(!load || !checkStartVertex(graph, vertex)){
 		printErrorCode(600);
 		return false;
 	}
-	std::streambuf* bak = std::cout.rdbuf(fout.rdbuf());
-	bool ok = Dijkstra(graph, option, vertex);
-	std::cout.rdbuf(bak);
-	return ok;
+	return runAlgo(ALGO_DIJKSTRA, makeArgs(option, vertex, 0, predOnly));
 }
 
 bool Manager::mKRUSKAL()
@@ -241,10 +678,16 @@ bool Manager::mKRUSKAL()
 		printErrorCode(500);
 		return false;
 	}
-	std::streambuf* bak = std::cout.rdbuf(fout.rdbuf());
-	bool ok = Kruskal(graph);
-	std::cout.rdbuf(bak);
-	return ok;
+	// retained tree still current (possibly maintained by INSERT / UPDATE)
+	if(mst.isCurrent(graph->getGeneration())){
+		std::streambuf* bak = std::cout.rdbuf(fout.rdbuf());
+		bool ok = printKruskal(mst);
+		std::cout.rdbuf(bak);
+		return ok;
+	}
+	AlgoArgs a = makeArgs('X', 0, 0, false);
+	a.tree = &mst;
+	return runAlgo(ALGO_KRUSKAL, a);
 }
 
 bool Manager::mBELLMANFORD(char option, int s_vertex, int e_vertex) 
@@ -253,22 +696,100 @@ bool Manager::mBELLMANFORD(char option, int s_vertex, int e_vertex)
 		printErrorCode(700);
 		return false;
 	}
-	std::streambuf* bak = std::cout.rdbuf(fout.rdbuf());
-	bool ok = Bellmanford(graph, option, s_vertex, e_vertex);
-	std::cout.rdbuf(bak);
-	return ok;
+	return runAlgo(ALGO_BELLMANFORD, makeArgs(option, s_vertex, e_vertex, false));
 }
 
-bool Manager::mFLOYD(char option)
+bool Manager::mFLOYD(char option, const std::vector<int>* rows)
 {
 	if(!load){
 		printErrorCode(800);
 		return false;
 	}
-	std::streambuf* bak = std::cout.rdbuf(fout.rdbuf());
-	bool ok = FLOYD(graph, option);
-	std::cout.rdbuf(bak);
-	return ok;
+	// retained matrix still current (possibly patched by INSERT / UPDATE): no recompute
+	DistMatrix& m = apsp[option == 'O' ? 0 : 1];
+	if(m.valid && m.gen == graph->getGeneration()){
+		std::streambuf* bak = std::cout.rdbuf(fout.rdbuf());
+		bool ok = printFloyd(*graph, option == 'O', m, rows);
+		std::cout.rdbuf(bak);
+		return ok;
+	}
+	m.clear();   // stale: free it before admission counts what is resident
+	AlgoArgs a = makeArgs(option, 0, 0, false);
+	a.keep = &m;
+	// a row subset never builds the matrix: one Dijkstra per requested source
+	a.rows = rows;
+	a.stream = rows != nullptr;
+	return runAlgo(ALGO_FLOYD, a);
+}
+
+bool Manager::mINSERT(int from, int to, int weight)
+{
+	return changeEdge(true, from, to, weight);
+}
+
+bool Manager::mUPDATE(int from, int to, int weight)
+{
+	return changeEdge(false, from, to, weight);
+}
+
+// INSERT (edge must be new) / UPDATE (edge must exist), original ids.
+// Retained FLOYD matrices are patched in O(n^2) and the retained MST in
+// O(log n) when the edge got cheaper in their view, dropped when it got dearer.
+bool Manager::changeEdge(bool insert, int from, int to, int weight)
+{
+	int code = insert ? 1300 : 1400;
+	if(!load || !checkStartVertex(graph, from) || !checkStartVertex(graph, to) || graph->isReadOnly()){
+		printErrorCode(code);
+		return false;
+	}
+	// weight 0 is "no edge" in a matrix
+	if(weight == 0 && dynamic_cast<MatrixGraph*>(graph)){
+		printErrorCode(code);
+		return false;
+	}
+	int u = graph->toInternal(from), v = graph->toInternal(to);
+	int old = 0;
+	bool exists = graph->getEdge(u, v, &old);
+	if(exists == insert){
+		printErrorCode(code);
+		return false;
+	}
+
+	// undirected weight of the pair = min of both directions, before and after
+	int rev = 0;
+	bool hasRev = u != v && graph->getEdge(v, u, &rev);
+	bool pairExisted = exists || hasRev;
+	int oldPair = exists && hasRev ? std::min(old, rev) : (exists ? old : rev);
+	int newPair = hasRev ? std::min(weight, rev) : weight;
+
+	unsigned before = graph->getGeneration();
+	graph->insertEdge(u, v, weight);
+	unsigned after = graph->getGeneration();
+	if(after != before){
+		// per view: the edge got cheaper (patch), kept its weight (restamp), or got dearer (drop)
+		int cmpO = !exists ? -1 : (weight < old ? -1 : (weight > old ? 1 : 0));
+		int cmpX = !pairExisted ? -1 : (newPair < oldPair ? -1 : (newPair > oldPair ? 1 : 0));
+		for(int k = 0; k < 2; ++k){
+			DistMatrix& m = apsp[k];
+			int cmp = k == 0 ? cmpO : cmpX;
+			if(!m.valid) continue;
+			if(m.gen != before || cmp > 0){ m.clear(); continue; }
+			if(cmp < 0) relaxEdge(m, graph->getSize(), u, v, k == 0 ? weight : newPair, k == 0);
+			m.gen = after;
+		}
+		if(mst.isValid()){
+			if(!mst.isCurrent(before) || cmpX > 0) mst.clear();
+			else {
+				if(cmpX < 0) mst.lower(from, to, newPair);
+				mst.setGeneration(after);
+			}
+		}
+	}
+
+	fout << (insert ? "========INSERT========\n" : "========UPDATE========\n");
+	fout << "Success\n";
+	fout << "======================\n\n";
+	return true;
 }
 
 bool Manager::mCentrality() {
@@ -276,10 +797,41 @@ bool Manager::mCentrality() {
 		printErrorCode(900);
 		return false;
 	}
-	std::streambuf* bak = std::cout.rdbuf(fout.rdbuf());
-	bool ok = Centrality(graph);
-	std::cout.rdbuf(bak);
-	return ok;
+	return runAlgo(ALGO_CENTRALITY, makeArgs('X', 0, 0, false));
+}
+
+bool Manager::STATS()
+{
+	fout << "========STATS========\n";
+	stats.print(fout, getGraph());
+	fout << "======================\n\n";
+	return true;
+}
+
+bool Manager::TRACE(const char* path)
+{
+	if(strcmp(path, "OFF") == 0) stats.closeTrace();
+	else if(!stats.openTrace(path)){
+		printErrorCode(1100);
+		return false;
+	}
+	fout << "========TRACE========\n";
+	fout << "Success\n";
+	fout << "======================\n\n";
+	return true;
+}
+
+bool Manager::MEMLIMIT(int mb)
+{
+	if(mb <= 0){
+		printErrorCode(1200);
+		return false;
+	}
+	memLimit = (size_t)mb << 20;
+	fout << "========MEMLIMIT========\n";
+	fout << mb << " MB\n";
+	fout << "======================\n\n";
+	return true;
 }
 
 void Manager::printErrorCode(int n)
@@ -2,6 +2,29 @@
 #define _MANAGER_H_
 
 #include "GraphMethod.h"
+#include "Reorder.h"
+#include "Stats.h"
+
+// Internal representation built by LOAD (independent of the file format)
+enum Backend {
+	BACKEND_AUTO,        // pick by edge density
+	BACKEND_LIST,        // ListGraph
+	BACKEND_MATRIX,      // MatrixGraph
+	BACKEND_COMPRESSED,  // CompressedGraph (read-only)
+	BACKEND_EXTERNAL     // ExternalGraph (read-only, edges on disk)
+};
+
+// Algorithm selector for the kernel dispatch
+enum Algo { ALGO_BFS, ALGO_DFS, ALGO_DIJKSTRA, ALGO_BELLMANFORD, ALGO_FLOYD, ALGO_KRUSKAL, ALGO_CENTRALITY };
+struct AlgoArgs {
+	char option;     // 'O' direct / 'X' undirect
+	int s, e;        // start / end vertex (original ids)
+	bool predOnly;   // DIJKSTRA PRED
+	DistMatrix* keep; // FLOYD result
+	DynamicMST* tree; // KRUSKAL result
+	bool stream;      // FLOYD / CENTRALITY: per-source engine (over the memory budget)
+	const std::vector<int>* rows; // FLOYD source rows (original ids, ascending), nullptr = all
+};
 
 // Command 
 class Manager{	
@@ -9,24 +32,47 @@ private:
 	Graph* graph;	    // current graph 
 	ofstream fout;	    // log.txt 
 	int load;           // 0 = not loaded, 1 = loaded
+	StatsLog stats;     // per-command timing / counters
+	size_t memLimit;    // MEMLIMIT in bytes, 0 = none (heap budget for admission)
+	DistMatrix apsp[2]; // last FLOYD per view: [0] 'O', [1] 'X'
+	DynamicMST mst;     // last KRUSKAL
+
+	bool runCommand(const std::vector<std::string>& tk);
+	// pick the specialized algorithm for the loaded backend and run it
+	bool runAlgo(Algo algo, const AlgoArgs& a);
+	bool loadExternal(std::ifstream& gin, char type_char, int n, ReorderMode reorder);
+	bool changeEdge(bool insert, int from, int to, int weight);
+	// admission: need more bytes on top of what is resident still within MEMLIMIT
+	size_t residentBytes();
+	bool fitsBudget(size_t need);
 
 public:
-	Manager();	
+	Manager(const char* log_txt = "log.txt");	
 	~Manager();	
 
+	// loaded graph or nullptr (benchmark / inspection)
+	Graph* getGraph();
+	// forget retained results so the next FLOYD recomputes (benchmark)
+	void dropRetained();
+
 	// Run using a command file
 	void run(const char * command_txt);
 	
 	// Commands
-	bool LOAD(const char* filename);	
-	bool PRINT();	
+	bool LOAD(const char* filename, ReorderMode reorder = REORDER_NONE, Backend backend = BACKEND_AUTO);	
+	bool PRINT(const std::vector<int>* rows = nullptr);	
 	bool mBFS(char option, int vertex);	
 	bool mDFS(char option, int vertex);	
-	bool mDIJKSTRA(char option, int vertex);	
+	bool mDIJKSTRA(char option, int vertex, bool predOnly = false);	
 	bool mKRUSKAL();	
 	bool mBELLMANFORD(char option, int s_vertex, int e_vertex);	
-	bool mFLOYD(char option); 
+	bool mFLOYD(char option, const std::vector<int>* rows = nullptr); 
+	bool mINSERT(int from, int to, int weight);
+	bool mUPDATE(int from, int to, int weight);
 	bool mCentrality();
+	bool STATS();
+	bool TRACE(const char* path);
+	bool MEMLIMIT(int mb);
 
 	// Error 
 	void printErrorCode(int n); 
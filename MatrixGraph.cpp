@@ -6,6 +6,7 @@
 
 MatrixGraph::MatrixGraph(bool type, int size) : Graph(type, size)
 {
+	m_Format = 'M';
 	m_Mat = new int*[m_Size];
 	for(int i = 0; i < m_Size; ++i) {
 		m_Mat[i] = new int[m_Size];
@@ -46,15 +47,41 @@ void MatrixGraph::getAdjacentEdgesDirect(int vertex, std::map<int, int>* out)
 	}
 }
 
+// row scan, columns are already ascending
+void MatrixGraph::getOutEdges(int vertex, std::vector<std::pair<int, int>>* out)
+{
+	out->clear();
+	if(vertex < 0 || vertex >= m_Size) return;
+	for(int v = 0; v < m_Size; ++v) {
+		if(m_Mat[vertex][v] != 0) out->push_back(std::make_pair(v, m_Mat[vertex][v]));
+	}
+}
+
 void MatrixGraph::insertEdge(int from, int to, int weight)	
 {
 	if(from < 0 || from >= m_Size || to < 0 || to >= m_Size) return;
+	// keep the summary in sync, 0 means no edge in the matrix
+	int old = m_Mat[from][to];
+	if(old == weight) return;
+	if(old != 0 && weight != 0) noteReweight(old, weight);
+	else if(old != 0) noteRemove(from, to, old);
+	else noteInsert(from, to, weight);
 	m_Mat[from][to] = weight;
 }
 
-bool MatrixGraph::printGraph(std::ofstream *fout)	
+bool MatrixGraph::getEdge(int from, int to, int* weight)
+{
+	if(from < 0 || from >= m_Size || to < 0 || to >= m_Size) return false;
+	if(m_Mat[from][to] == 0) return false;
+	*weight = m_Mat[from][to];
+	return true;
+}
+
+bool MatrixGraph::printGraph(std::ofstream *fout, const std::vector<int>* rows)	
 {
 	if(!fout || !fout->is_open()) return false;
+	// loaded from a list file: print it back as a list
+	if(m_Format != 'M') return Graph::printGraph(fout, rows);
 
 	(*fout) << "========PRINT========\n";
 	// header
@@ -62,7 +89,8 @@ bool MatrixGraph::printGraph(std::ofstream *fout)
 	for(int j = 0; j < m_Size; ++j) (*fout) << "[" << j << "] ";
 	(*fout) << "\n";
 	// rows
-	for(int i = 0; i < m_Size; ++i) {
+	for(size_t k = 0; k < rowCount(rows, m_Size); ++k) {
+		int i = rowAt(rows, k);
 		(*fout) << "[" << i << "] ";
 		for(int j = 0; j < m_Size; ++j) {
 			(*fout) << m_Mat[i][j] << (j+1==m_Size? "" : "  ");
@@ -71,4 +99,9 @@ bool MatrixGraph::printGraph(std::ofstream *fout)
 	}
 	(*fout) << "======================\n\n";
 	return true;
-}
\ No newline at end of file
+}
+
+size_t MatrixGraph::getMemoryBytes()
+{
+	return Graph::getMemoryBytes() + sizeof(int*) * m_Size + sizeof(int) * (size_t)m_Size * m_Size;
+}
@@ -14,8 +14,28 @@ public:
 		
 	void getAdjacentEdges(int vertex, std::map<int, int>* m) override;	
 	void getAdjacentEdgesDirect(int vertex, std::map<int, int>* m) override;
+	void getOutEdges(int vertex, std::vector<std::pair<int, int>>* out) override;
 	void insertEdge(int from, int to, int weight) override;	
-	bool printGraph(std::ofstream *fout) override;
+	bool getEdge(int from, int to, int* weight) override;
+	bool printGraph(std::ofstream *fout, const std::vector<int>* rows = nullptr) override;
+	size_t getMemoryBytes() override;
+	size_t getPendingUndirectedBytes() override { return 0; }   // row/column merge
+
+	// Static iteration for the kernels in GraphMethod.cpp: f(v, w), ascending id
+	template<class F> void forEachOut(int u, F f) {
+		const int* row = m_Mat[u];
+		for(int v = 0; v < m_Size; ++v) if(row[v] != 0) f(v, row[v]);
+	}
+	// row u merged with column u, smaller weight when both directions exist
+	template<class F> void forEachUndir(int u, F f) {
+		const int* row = m_Mat[u];
+		for(int v = 0; v < m_Size; ++v) {
+			int a = row[v], b = m_Mat[v][u];
+			if(a != 0 && b != 0) f(v, a < b ? a : b);
+			else if(a != 0) f(v, a);
+			else if(b != 0) f(v, b);
+		}
+	}
 };
 
 #endif
\ No newline at end of file
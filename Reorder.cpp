@@ -0,0 +1,89 @@
+#include "Reorder.h"
+#include <string>
+#include <queue>
+#include <algorithm>
+
+bool parseReorderMode(const std::string& s, ReorderMode* mode)
+{
+	if(s == "BFS") *mode = REORDER_BFS;
+	else if(s == "RCM") *mode = REORDER_RCM;
+	else if(s == "DEGREE") *mode = REORDER_DEGREE;
+	else return false;
+	return true;
+}
+
+// undirected adjacency in CSR form (self loops dropped, duplicates kept)
+static void buildSymmetric(int n, const std::vector<Edge>& edges, std::vector<int>& off, std::vector<int>& nbr)
+{
+	off.assign(n + 1, 0);
+	for(const auto& e : edges) {
+		if(e.u == e.v) continue;
+		off[e.u + 1]++;
+		off[e.v + 1]++;
+	}
+	for(int i = 0; i < n; ++i) off[i + 1] += off[i];
+	nbr.assign(off[n], 0);
+	std::vector<int> pos(off.begin(), off.end() - 1);
+	for(const auto& e : edges) {
+		if(e.u == e.v) continue;
+		nbr[pos[e.u]++] = e.v;
+		nbr[pos[e.v]++] = e.u;
+	}
+	// ascending ids keep the order deterministic
+	for(int u = 0; u < n; ++u) std::sort(nbr.begin() + off[u], nbr.begin() + off[u + 1]);
+}
+
+// BFS over every component; byDegree visits neighbors (and picks roots) by ascending degree
+static void bfsOrder(int n, const std::vector<int>& off, const std::vector<int>& nbr, bool byDegree, std::vector<int>& order)
+{
+	auto deg = [&off](int v){ return off[v + 1] - off[v]; };
+	std::vector<int> roots(n);
+	for(int i = 0; i < n; ++i) roots[i] = i;
+	if(byDegree) std::stable_sort(roots.begin(), roots.end(), [&](int a, int b){ return deg(a) < deg(b); });
+
+	std::vector<char> seen(n, 0);
+	std::vector<int> next;
+	order.clear();
+	for(int r : roots) {
+		if(seen[r]) continue;
+		seen[r] = 1;
+		size_t head = order.size();
+		order.push_back(r);
+		// order itself is the queue
+		while(head < order.size()) {
+			int u = order[head++];
+			next.clear();
+			for(int i = off[u]; i < off[u + 1]; ++i) {
+				int v = nbr[i];
+				if(!seen[v]) { seen[v] = 1; next.push_back(v); }
+			}
+			if(byDegree) std::stable_sort(next.begin(), next.end(), [&](int a, int b){ return deg(a) < deg(b); });
+			order.insert(order.end(), next.begin(), next.end());
+		}
+	}
+}
+
+void computeOrder(int n, const std::vector<Edge>& edges, ReorderMode mode, std::vector<int>* toInternal)
+{
+	std::vector<int> order; // order[k] = original id placed at internal slot k
+	if(mode == REORDER_DEGREE) {
+		std::vector<int> deg(n, 0);
+		for(const auto& e : edges) { deg[e.u]++; deg[e.v]++; }
+		order.resize(n);
+		for(int i = 0; i < n; ++i) order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&deg](int a, int b){ return deg[a] > deg[b]; });
+	}
+	else if(mode == REORDER_BFS || mode == REORDER_RCM) {
+		std::vector<int> off, nbr;
+		buildSymmetric(n, edges, off, nbr);
+		bfsOrder(n, off, nbr, mode == REORDER_RCM, order);
+		if(mode == REORDER_RCM) std::reverse(order.begin(), order.end());
+	}
+	else {
+		order.resize(n);
+		for(int i = 0; i < n; ++i) order[i] = i;
+	}
+
+	toInternal->assign(n, 0);
+	for(int k = 0; k < n; ++k) (*toInternal)[order[k]] = k;
+}
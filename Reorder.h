@@ -0,0 +1,20 @@
+#ifndef _REORDER_H_
+#define _REORDER_H_
+
+#include "Graph.h"
+
+// LOAD-time vertex relabeling for cache locality
+enum ReorderMode {
+	REORDER_NONE,     // keep input ids
+	REORDER_BFS,      // BFS discovery order (undirected view)
+	REORDER_RCM,      // Reverse Cuthill-McKee (bandwidth reduction)
+	REORDER_DEGREE    // descending degree, hubs packed together
+};
+
+// "BFS" / "RCM" / "DEGREE" -> mode, false for unknown token
+bool parseReorderMode(const std::string& s, ReorderMode* mode);
+
+// Compute toInternal[original id] = internal id for the given edge list
+void computeOrder(int n, const std::vector<Edge>& edges, ReorderMode mode, std::vector<int>* toInternal);
+
+#endif
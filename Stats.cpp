@@ -0,0 +1,139 @@
+#include "Stats.h"
+#include <sys/resource.h>
+
+StatCounters g_Counters;
+StatPhases g_Phases;
+size_t g_WorkBytes = 0;
+
+PhaseTimer::PhaseTimer(double* acc)
+{
+	m_Acc = acc;
+	m_Start = std::chrono::steady_clock::now();
+}
+
+PhaseTimer::~PhaseTimer()
+{
+	*m_Acc += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count();
+}
+
+StatsLog::StatsLog()
+{
+	m_PeakGraphBytes = 0;
+	m_GraphBase = 0;
+	m_RssBase = 0;
+	m_EstBytes = 0;
+	m_Cpu0 = 0;
+}
+
+StatsLog::~StatsLog()
+{
+	closeTrace();
+}
+
+static long maxRssKB()
+{
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_maxrss;
+}
+
+// reset the per-command state
+void StatsLog::begin(Graph* g)
+{
+	memset(&g_Counters, 0, sizeof(g_Counters));
+	memset(&g_Phases, 0, sizeof(g_Phases));
+	g_WorkBytes = 0;
+	m_EstBytes = 0;
+	m_GraphBase = g ? g->getMemoryBytes() : 0;
+	m_RssBase = maxRssKB();
+	m_Wall0 = std::chrono::steady_clock::now();
+	m_Cpu0 = std::clock();
+}
+
+void StatsLog::end(const std::string& name, Graph* g)
+{
+	double wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Wall0).count();
+	double cpu = 1000.0 * (std::clock() - m_Cpu0) / CLOCKS_PER_SEC;
+	size_t bytes = g ? g->getMemoryBytes() : 0;
+	// ru_maxrss only moves past its old high-water mark (page granular),
+	// the accounted part covers commands that reuse freed memory
+	size_t rss = (size_t)(maxRssKB() - m_RssBase) * 1024;
+	size_t peak = std::max(rss, (bytes > m_GraphBase ? bytes - m_GraphBase : 0) + g_WorkBytes);
+	m_PeakGraphBytes = std::max(m_PeakGraphBytes, bytes);
+
+	// first time this command is seen
+	if(m_Agg.find(name) == m_Agg.end()) {
+		Agg a;
+		memset(&a, 0, sizeof(a));
+		m_Agg[name] = a;
+		m_Order.push_back(name);
+	}
+	Agg& a = m_Agg[name];
+	a.calls++;
+	a.wallMs += wall;
+	a.cpuMs += cpu;
+	a.c.settled += g_Counters.settled;
+	a.c.scanned += g_Counters.scanned;
+	a.c.relaxed += g_Counters.relaxed;
+	a.c.heapPush += g_Counters.heapPush;
+	a.c.heapPop += g_Counters.heapPop;
+	a.p.parseMs += g_Phases.parseMs;
+	a.p.buildMs += g_Phases.buildMs;
+	a.p.formatMs += g_Phases.formatMs;
+	a.estBytes = std::max(a.estBytes, m_EstBytes);
+	a.peakBytes = std::max(a.peakBytes, peak);
+
+	if(m_Trace.is_open()) {
+		m_Trace << name << "," << wall << "," << cpu << "," << g_Phases.parseMs << "," << g_Phases.buildMs << ","
+			<< g_Phases.formatMs << "," << g_Counters.settled << "," << g_Counters.scanned << ","
+			<< g_Counters.relaxed << "," << g_Counters.heapPush << "," << g_Counters.heapPop << "," << bytes << "," << m_EstBytes << "," << peak << "\n";
+	}
+}
+
+// the last estimate wins: admission fallbacks (matrix -> list, dense -> streamed) note again
+void StatsLog::noteEstimate(size_t bytes)
+{
+	m_EstBytes = bytes;
+}
+
+bool StatsLog::openTrace(const char* path)
+{
+	closeTrace();
+	m_Trace.open(path, ios::out | ios::trunc);
+	if(!m_Trace.is_open()) return false;
+	m_Trace << "command,wall_ms,cpu_ms,parse_ms,build_ms,format_ms,settled,scanned,relaxed,heap_push,heap_pop,graph_bytes,est_bytes,peak_bytes\n";
+	return true;
+}
+
+void StatsLog::closeTrace()
+{
+	if(m_Trace.is_open()) m_Trace.close();
+}
+
+void StatsLog::print(std::ostream& os, Graph* g)
+{
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+
+	if(g) os << "Graph: " << g->getSize() << " vertices, " << g->getEdgeCount() << " edges, " << g->getMemoryBytes() << " bytes\n";
+	else os << "Graph: none\n";
+	os << "Peak graph bytes: " << m_PeakGraphBytes << "\n";
+	os << "Peak RSS: " << ru.ru_maxrss << " KB\n";
+	for(const auto& name : m_Order) {
+		const Agg& a = m_Agg[name];
+		os << "[" << name << "] calls " << a.calls << ", wall " << a.wallMs << " ms, cpu " << a.cpuMs << " ms";
+		if(name == "LOAD") os << ", parse " << a.p.parseMs << " ms, build " << a.p.buildMs << " ms";
+		os << ", format " << a.p.formatMs << " ms";
+		// memory growth within one call (LOAD: the new graph), and what admission expected
+		os << ", peak " << a.peakBytes / 1024 << " KB";
+		if(a.estBytes) os << " (est " << a.estBytes / 1024 << " KB)";
+#ifdef GRAPH_STATS
+		os << ", settled " << a.c.settled << ", scanned " << a.c.scanned << ", relaxed " << a.c.relaxed
+			<< ", heap " << a.c.heapPush << "/" << a.c.heapPop;
+#endif
+		os << "\n";
+	}
+#ifndef GRAPH_STATS
+	os << "Counters: off (build with STATS=1)\n";
+#endif
+}
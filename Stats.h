@@ -0,0 +1,94 @@
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include "Graph.h"
+#include <string>
+#include <ctime>
+#include <chrono>
+
+// Hot-path counters of the running command (algorithms in GraphMethod.cpp).
+// Built only with -DGRAPH_STATS (make STATS=1, the default); otherwise every
+// STAT_* macro expands to nothing.
+struct StatCounters {
+	long long settled;    // vertices finalized / visited
+	long long scanned;    // edges looked at
+	long long relaxed;    // edges that improved a distance (or joined the MST)
+	long long heapPush;
+	long long heapPop;
+};
+extern StatCounters g_Counters;
+
+#ifdef GRAPH_STATS
+#define STAT_INC(field) (++g_Counters.field)
+#define STAT_ADD(field, k) (g_Counters.field += (k))
+#else
+#define STAT_INC(field) ((void)0)
+#define STAT_ADD(field, k) ((void)0)
+#endif
+
+// Per-command phase times in ms (measured once per phase, always on)
+struct StatPhases {
+	double parseMs;    // LOAD: reading the file
+	double buildMs;    // LOAD: constructing the graph
+	double formatMs;   // writing the result block
+};
+extern StatPhases g_Phases;
+
+// Working memory of the running command as the kernels report it (their
+// buffers at the largest point), always on; noteWorkBytes keeps the maximum
+extern size_t g_WorkBytes;
+inline void noteWorkBytes(size_t bytes) { if(bytes > g_WorkBytes) g_WorkBytes = bytes; }
+
+// adds the scope's wall time to *acc
+class PhaseTimer{
+private:
+	double* m_Acc;
+	std::chrono::steady_clock::time_point m_Start;
+public:
+	explicit PhaseTimer(double* acc);
+	~PhaseTimer();
+};
+
+// Per-command bookkeeping: begin/end around every command of Manager::run,
+// aggregated by command name for STATS and optionally traced line by line.
+class StatsLog{
+private:
+	struct Agg {
+		int calls;
+		double wallMs, cpuMs;
+		StatCounters c;
+		StatPhases p;
+		size_t estBytes;    // largest admission estimate
+		size_t peakBytes;   // largest memory growth during one call
+	};
+	std::map<std::string, Agg> m_Agg;
+	std::vector<std::string> m_Order;    // command names in first-seen order
+	size_t m_PeakGraphBytes;
+	size_t m_GraphBase;    // graph bytes at begin()
+	long m_RssBase;        // ru_maxrss (KB) at begin()
+	size_t m_EstBytes;     // estimate noted by the running command
+	std::ofstream m_Trace;
+
+	std::chrono::steady_clock::time_point m_Wall0;
+	std::clock_t m_Cpu0;
+
+public:
+	StatsLog();
+	~StatsLog();
+
+	// Peak of one command = the larger of the ru_maxrss growth and the graph's
+	// getMemoryBytes() growth plus what the kernels reported (noteWorkBytes)
+	void begin(Graph* g);
+	void end(const std::string& name, Graph* g);
+	// working-set estimate the running command was admitted with
+	void noteEstimate(size_t bytes);
+
+	// one CSV line per command to path; false if it cannot be opened
+	bool openTrace(const char* path);
+	void closeTrace();
+
+	// STATS block body
+	void print(std::ostream& os, Graph* g);
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "BenchGen.h"
+#include <random>
+#include <cstdio>
+
+void genRandomSparse(int n, int avgDeg, int maxW, unsigned seed, std::vector<Edge>& edges)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> pick(0, n - 1), wt(1, maxW);
+	edges.clear();
+	for(int u = 0; u < n; ++u)
+		for(int k = 0; k < avgDeg; ++k) edges.push_back({u, pick(rng), wt(rng)});
+}
+
+void genRmat(int n, int avgDeg, int maxW, unsigned seed, std::vector<Edge>& edges)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> coin(0.0, 1.0);
+	std::uniform_int_distribution<int> wt(1, maxW);
+	int levels = 0;
+	while((1 << levels) < n) levels++;
+	edges.clear();
+	long long m = (long long)n * avgDeg;
+	while((long long)edges.size() < m) {
+		// descend the quadrants of the adjacency matrix
+		int u = 0, v = 0;
+		for(int l = 0; l < levels; ++l) {
+			double r = coin(rng);
+			u <<= 1; v <<= 1;
+			if(r < 0.57) {}
+			else if(r < 0.76) v |= 1;
+			else if(r < 0.95) u |= 1;
+			else { u |= 1; v |= 1; }
+		}
+		if(u < n && v < n) edges.push_back({u, v, wt(rng)});
+	}
+}
+
+void genGrid(int n, int maxW, unsigned seed, std::vector<Edge>& edges)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> wt(1, maxW);
+	int side = 1;
+	while((side + 1) * (side + 1) <= n) side++;
+	edges.clear();
+	// road-like: 4-neighborhood, each street both ways
+	for(int r = 0; r < side; ++r) {
+		for(int c = 0; c < side; ++c) {
+			int u = r * side + c;
+			if(c + 1 < side) { int w = wt(rng); edges.push_back({u, u + 1, w}); edges.push_back({u + 1, u, w}); }
+			if(r + 1 < side) { int w = wt(rng); edges.push_back({u, u + side, w}); edges.push_back({u + side, u, w}); }
+		}
+	}
+}
+
+void genChain(int n, int maxW, unsigned seed, std::vector<Edge>& edges)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> wt(1, maxW);
+	edges.clear();
+	for(int u = 0; u + 1 < n; ++u) edges.push_back({u, u + 1, wt(rng)});
+}
+
+void genDense(int n, double p, int maxW, unsigned seed, std::vector<Edge>& edges)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> coin(0.0, 1.0);
+	std::uniform_int_distribution<int> wt(1, maxW);
+	edges.clear();
+	for(int u = 0; u < n; ++u)
+		for(int v = 0; v < n; ++v)
+			if(u != v && coin(rng) < p) edges.push_back({u, v, wt(rng)});
+}
+
+bool generateByName(const std::string& name, int n, int avgDeg, unsigned seed, std::vector<Edge>& edges)
+{
+	if(name == "random") genRandomSparse(n, avgDeg, 100, seed, edges);
+	else if(name == "rmat") genRmat(n, avgDeg, 100, seed, edges);
+	else if(name == "grid") genGrid(n, 100, seed, edges);
+	else if(name == "chain") genChain(n, 100, seed, edges);
+	else if(name == "dense") genDense(n, 0.5, 100, seed, edges);
+	else return false;
+	return true;
+}
+
+// "L n", then per vertex: id line and one line of "to weight" pairs
+bool writeListFile(const char* path, int n, const std::vector<Edge>& edges)
+{
+	FILE* f = fopen(path, "w");
+	if(!f) return false;
+	std::vector<std::vector<std::pair<int,int>>> adj(n);
+	for(const auto& e : edges) adj[e.u].push_back(std::make_pair(e.v, e.w));
+	fprintf(f, "L %d\n", n);
+	for(int u = 0; u < n; ++u) {
+		fprintf(f, "%d\n", u);
+		if(adj[u].empty()) continue;
+		for(size_t i = 0; i < adj[u].size(); ++i) fprintf(f, i ? " %d %d" : "%d %d", adj[u][i].first, adj[u][i].second);
+		fprintf(f, "\n");
+	}
+	fclose(f);
+	return true;
+}
+
+// "M n", then n rows of n weights (0 = no edge)
+bool writeMatrixFile(const char* path, int n, const std::vector<Edge>& edges)
+{
+	FILE* f = fopen(path, "w");
+	if(!f) return false;
+	std::vector<std::vector<int>> row(n);
+	for(const auto& e : edges) {
+		if(row[e.u].empty()) row[e.u].assign(n, 0);
+		row[e.u][e.v] = e.w;
+	}
+	fprintf(f, "M %d\n", n);
+	for(int u = 0; u < n; ++u) {
+		for(int v = 0; v < n; ++v) fprintf(f, v ? " %d" : "%d", row[u].empty() ? 0 : row[u][v]);
+		fprintf(f, "\n");
+	}
+	fclose(f);
+	return true;
+}
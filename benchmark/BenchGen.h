@@ -0,0 +1,21 @@
+#ifndef _BENCHGEN_H_
+#define _BENCHGEN_H_
+
+#include "Graph.h"
+#include <string>
+
+// Synthetic graph generators for the benchmark (directed edges, weights 1..maxW)
+void genRandomSparse(int n, int avgDeg, int maxW, unsigned seed, std::vector<Edge>& edges);
+void genRmat(int n, int avgDeg, int maxW, unsigned seed, std::vector<Edge>& edges);   // power-law (a,b,c = .57,.19,.19)
+void genGrid(int n, int maxW, unsigned seed, std::vector<Edge>& edges);               // sqrt(n) x sqrt(n), both directions
+void genChain(int n, int maxW, unsigned seed, std::vector<Edge>& edges);              // 0 -> 1 -> ... -> n-1
+void genDense(int n, double p, int maxW, unsigned seed, std::vector<Edge>& edges);    // every pair with probability p
+
+// by name: "random", "rmat", "grid", "chain", "dense"; false for unknown name
+bool generateByName(const std::string& name, int n, int avgDeg, unsigned seed, std::vector<Edge>& edges);
+
+// Write in the LOAD input formats ('L' adjacency list, 'M' matrix)
+bool writeListFile(const char* path, int n, const std::vector<Edge>& edges);
+bool writeMatrixFile(const char* path, int n, const std::vector<Edge>& edges);
+
+#endif
@@ -0,0 +1,192 @@
+// Benchmark harness: synthetic graphs x input format x backend x command
+// build: make bench
+// run:   ./bench [-n 500,5000] [-d 8] [-g random,rmat,grid,chain,dense] [-r 3]
+//                [-o results.csv] [--json] [--dir bench_data]
+//                [--floyd-max 800] [--matrix-max 4000] [--dense-max 1500]
+// One result row per (graph, scale, format, backend, command): min and mean wall time
+// over the repetitions plus the loaded graph's bytes, as CSV (default) or JSON.
+#include "Manager.h"
+#include "BenchGen.h"
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <cstdlib>
+#include <sys/stat.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+	std::vector<int> scales;
+	std::vector<std::string> graphs;
+	int avgDeg, reps;
+	int floydMax, matrixMax, denseMax;
+	std::string dir, out;
+	bool json;
+};
+
+struct BenchRow {
+	std::string graph, format, backend, command;
+	int scale, vertices, edges;
+	size_t bytes;
+	double minMs, meanMs;
+};
+
+static std::vector<std::string> splitComma(const std::string& s)
+{
+	std::vector<std::string> t;
+	std::stringstream ss(s);
+	std::string w;
+	while(std::getline(ss, w, ',')) if(!w.empty()) t.push_back(w);
+	return t;
+}
+
+static bool parseArgs(int argc, char** argv, BenchConfig& c)
+{
+	c.scales = {500, 5000};
+	c.graphs = {"random", "rmat", "grid", "chain", "dense"};
+	c.avgDeg = 8; c.reps = 3;
+	c.floydMax = 800; c.matrixMax = 4000; c.denseMax = 1500;
+	c.dir = "bench_data"; c.json = false;
+
+	for(int i = 1; i < argc; ++i) {
+		std::string a = argv[i];
+		bool hasVal = i + 1 < argc;
+		if(a == "--json") c.json = true;
+		else if(!hasVal) return false;
+		else if(a == "-n") { c.scales.clear(); for(auto& s : splitComma(argv[++i])) c.scales.push_back(atoi(s.c_str())); }
+		else if(a == "-g") c.graphs = splitComma(argv[++i]);
+		else if(a == "-d") c.avgDeg = atoi(argv[++i]);
+		else if(a == "-r") c.reps = std::max(1, atoi(argv[++i]));
+		else if(a == "-o") c.out = argv[++i];
+		else if(a == "--dir") c.dir = argv[++i];
+		else if(a == "--floyd-max") c.floydMax = atoi(argv[++i]);
+		else if(a == "--matrix-max") c.matrixMax = atoi(argv[++i]);
+		else if(a == "--dense-max") c.denseMax = atoi(argv[++i]);
+		else return false;
+	}
+	return true;
+}
+
+// run fn reps times, min and mean in ms
+static void timeIt(int reps, const std::function<void()>& fn, double& minMs, double& meanMs)
+{
+	minMs = 1e300; meanMs = 0;
+	for(int r = 0; r < reps; ++r) {
+		Clock::time_point t0 = Clock::now();
+		fn();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+		minMs = std::min(minMs, ms);
+		meanMs += ms / reps;
+	}
+}
+
+// LOAD the file into one backend and time every command on it
+static void benchOne(const BenchConfig& c, const std::string& gname, int scale, const std::string& path,
+	const char* format, const char* backend, Backend which, std::vector<BenchRow>& rows)
+{
+	std::string logPath = c.dir + "/log_bench.txt";
+	Manager mgr(logPath.c_str());
+
+	BenchRow base;
+	base.graph = gname; base.scale = scale; base.format = format; base.backend = backend;
+
+	double mn, mean;
+	timeIt(c.reps, [&]{ mgr.LOAD(path.c_str(), REORDER_NONE, which); }, mn, mean);
+	Graph* g = mgr.getGraph();
+	if(!g) { std::cerr << "LOAD failed: " << path << "\n"; return; }
+	base.vertices = g->getSize();
+	base.edges = g->getEdgeCount();
+	base.bytes = g->getMemoryBytes();
+
+	BenchRow r = base;
+	r.command = "LOAD"; r.minMs = mn; r.meanMs = mean;
+	rows.push_back(r);
+
+	int n = g->getSize();
+	bool cubicOk = n <= c.floydMax;
+	std::vector<std::pair<std::string, std::function<void()>>> cmds;
+	cmds.push_back({"BFS O", [&]{ mgr.mBFS('O', 0); }});
+	cmds.push_back({"BFS X", [&]{ mgr.mBFS('X', 0); }});
+	cmds.push_back({"DFS O", [&]{ mgr.mDFS('O', 0); }});
+	cmds.push_back({"DFS X", [&]{ mgr.mDFS('X', 0); }});
+	cmds.push_back({"DIJKSTRA O", [&]{ mgr.mDIJKSTRA('O', 0); }});
+	cmds.push_back({"DIJKSTRA O PRED", [&]{ mgr.mDIJKSTRA('O', 0, true); }});
+	cmds.push_back({"BELLMANFORD O", [&]{ mgr.mBELLMANFORD('O', 0, n - 1); }});
+	// KRUSKAL / FLOYD keep their result; drop it so every rep recomputes
+	cmds.push_back({"KRUSKAL", [&]{ mgr.dropRetained(); mgr.mKRUSKAL(); }});
+	if(cubicOk) {
+		cmds.push_back({"FLOYD O", [&]{ mgr.dropRetained(); mgr.mFLOYD('O'); }});
+		cmds.push_back({"CENTRALITY", [&]{ mgr.mCentrality(); }});
+	}
+
+	for(auto& cmd : cmds) {
+		timeIt(c.reps, cmd.second, mn, mean);
+		r = base;
+		r.command = cmd.first; r.minMs = mn; r.meanMs = mean;
+		rows.push_back(r);
+		std::cerr << gname << " n=" << scale << " " << backend << " " << cmd.first << ": " << mn << " ms\n";
+	}
+}
+
+static void writeRows(std::ostream& os, const std::vector<BenchRow>& rows, bool json)
+{
+	if(json) {
+		os << "[\n";
+		for(size_t i = 0; i < rows.size(); ++i) {
+			const BenchRow& r = rows[i];
+			os << "  {\"graph\":\"" << r.graph << "\",\"scale\":" << r.scale << ",\"format\":\"" << r.format
+				<< "\",\"backend\":\"" << r.backend << "\",\"vertices\":" << r.vertices << ",\"edges\":" << r.edges
+				<< ",\"bytes\":" << r.bytes << ",\"command\":\"" << r.command << "\",\"min_ms\":" << r.minMs
+				<< ",\"mean_ms\":" << r.meanMs << "}" << (i + 1 < rows.size() ? "," : "") << "\n";
+		}
+		os << "]\n";
+		return;
+	}
+	os << "graph,scale,format,backend,vertices,edges,bytes,command,min_ms,mean_ms\n";
+	for(const auto& r : rows) {
+		os << r.graph << "," << r.scale << "," << r.format << "," << r.backend << "," << r.vertices << ","
+			<< r.edges << "," << r.bytes << "," << r.command << "," << r.minMs << "," << r.meanMs << "\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchConfig c;
+	if(!parseArgs(argc, argv, c)) {
+		std::cerr << "usage: " << argv[0] << " [-n 500,5000] [-d deg] [-g random,rmat,grid,chain,dense] [-r reps]"
+			" [-o file] [--json] [--dir dir] [--floyd-max n] [--matrix-max n] [--dense-max n]\n";
+		return 1;
+	}
+	mkdir(c.dir.c_str(), 0755);
+
+	std::vector<BenchRow> rows;
+	std::vector<Edge> edges;
+	for(int scale : c.scales) {
+		for(const auto& gname : c.graphs) {
+			if(gname == "dense" && scale > c.denseMax) continue;
+			if(!generateByName(gname, scale, c.avgDeg, 12345u + scale, edges)) {
+				std::cerr << "unknown graph: " << gname << "\n";
+				return 1;
+			}
+			std::string base = c.dir + "/" + gname + "_" + std::to_string(scale);
+			std::string lpath = base + "_L.txt", mpath = base + "_M.txt";
+
+			writeListFile(lpath.c_str(), scale, edges);
+			benchOne(c, gname, scale, lpath, "L", "list", BACKEND_LIST, rows);
+			benchOne(c, gname, scale, lpath, "L", "compressed", BACKEND_COMPRESSED, rows);
+			benchOne(c, gname, scale, lpath, "L", "auto", BACKEND_AUTO, rows);
+			if(scale <= c.matrixMax) {
+				writeMatrixFile(mpath.c_str(), scale, edges);
+				benchOne(c, gname, scale, mpath, "M", "matrix", BACKEND_MATRIX, rows);
+				benchOne(c, gname, scale, mpath, "M", "auto", BACKEND_AUTO, rows);
+			}
+		}
+	}
+
+	if(c.out.empty()) writeRows(std::cout, rows, c.json);
+	else {
+		std::ofstream of(c.out.c_str());
+		writeRows(of, rows, c.json);
+	}
+	return 0;
+}